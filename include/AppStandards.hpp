@@ -16,9 +16,26 @@ typedef std::string string;
 // travelClient parameters
 #define PERMS 0775
 #define LOGS_PATH "logs/"
+// Milliseconds to wait before connecting again to monitors that aren't up yet
+#define CONNECT_RETRY_DELAY 10
 
 // monitorServer parameters
 #define CITIZEN_REGISTRY_SIZE 1000
+// citizenIDs below this limit are indexed directly instead of hashed, as long as
+// they are dense enough (see CitizenRegistry.hpp). 0 disables it.
+#define DENSE_REGISTRY_LIMIT 1048576
+// Target false positive rate of every virus bloom filter. Its first layer is
+// sizeOfBloom bytes while the files are loaded, then it's sized for the citizens
+// that were vaccinated, and larger layers are added as more of them are
+// (see ScalableBloomFilter.hpp), so the rate holds however many they are
+#define BLOOM_TARGET_FPR 0.01
+// Whole bloom filters are sent run-length encoded when that's smaller (0 to send them raw)
+#define BLOOM_WIRE_ENCODING 1
+// Type of filter the monitors send to the travelClient for every changed virus
+#define BLOOM_FILTER 0
+#define XOR_FILTER 1     // Static xor filters, with fewer false positives
+#define ROARING_FILTER 2  // Exact roaring bitmaps of the vaccinated IDs
+#define CLIENT_FILTER_TYPE BLOOM_FILTER
 #define VIRUS_COUNTRY_ENTRIES 100
 
 // System messages - travelClient
@@ -46,6 +63,7 @@ typedef std::string string;
 #define MONITOR_STOPPED(PID) "Monitor " << PID << " is down.\n"
 #define LISTENING_TO(PID, PORT) "Monitor " << PID << " listening for connections to port " << PORT << "\n"
 #define ACCEPTED_CONN(PID, CLI) "Monitor " << PID << " accepted new connection from \"" << CLI << "\"\n"
+#define CLIENT_LOST(PID) "Monitor " << PID << " lost a client that didn't exit\n"
 
 // Query messages
 #define COUT_REQ_REJECTED "\nREQUEST REJECTED - YOU ARE NOT VACCINATED\n"
@@ -58,6 +76,7 @@ typedef std::string string;
 #define DATABASE_UPDATED "\nTHE DATABASE HAS BEEN UPDATED\n"
 #define VACCINATED "VACCINATED ON "
 #define NOT_VACCINATED "NOT YET VACCINATED"
+#define BLOOM_STATISTICS "BLOOM FILTER STATISTICS"
 
 // Error messages
 #define ARGS_NUMBER "\nINVALID NUMBER OF ARGUMENTS\n"
@@ -75,12 +94,9 @@ typedef std::string string;
 #define DUPLICATE_RECORD "DUPLICATE RECORD: "
 #define INCONSISTENT_RECORD "ERROR IN RECORD: "
 
-// Socket-message types
-#define REQUEST "REQUEST"
+// Request outcomes, as printed in the statistics
 #define ACCEPTED "ACCEPTED"
 #define REJECTED "REJECTED"
-#define UPDATE "UPDATE"
-#define NOT_FOUND "404"
 
 // travelClient error codes
 enum travelErrors {
@@ -124,7 +140,8 @@ enum menuOptions {
     travelStats = 2,
     addRecords = 3,
     searchStatus = 4,
-    help = 5
+    help = 5,
+    bloomStats = 6
 };
 
 bool checkTravelArgs(List<std::string> &args);
@@ -0,0 +1,192 @@
+#ifndef BLOCKEDBLOOMFILTER_HPP
+#define BLOCKEDBLOOMFILTER_HPP
+
+#define BLOOM_BLOCK_BYTES 64  // One cache line
+#define BLOOM_BLOCK_LANES 16  // 32-bit words per block, one bit is set in each
+
+#include <arpa/inet.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include <cstring>
+#include <iostream>
+
+#include "BloomFilter.hpp"
+#include "hashFunctions.hpp"
+
+// A 64-byte block seen as 16 lanes of 32 bits. GCC lowers operations on this
+// type to whatever SIMD instructions the target offers (SSE2, AVX2, AVX-512).
+typedef uint32_t bloomBlock __attribute__((vector_size(BLOOM_BLOCK_BYTES)));
+
+// Split-block Bloom filter: every key is mapped to a single cache line and
+// sets exactly one bit in each of its 16 lanes, picked by multiplying one
+// 32-bit hash with a different odd salt per lane. All the probes of a key are
+// done with a handful of vector instructions and cost a single cache miss.
+// The lanes are kept in network byte order, so the blocks are sent as they are.
+class BlockedBloomFilter {
+   private:
+    unsigned int size;  // in bits!
+    unsigned int numBlocks;
+    bloomBlock *blocks;
+
+    // Builds the mask with the single bit of every lane that key sets, in network
+    // byte order. Vectors are passed by reference to keep the ABI the same on every target.
+    static void makeMask(uint32_t key, bloomBlock &mask) {
+        static const uint32_t salts[BLOOM_BLOCK_LANES] = {
+            0x47b6137bU, 0x44974d91U, 0x8824ad5bU, 0xa2b7289dU,
+            0x705495c7U, 0x2df1424bU, 0x9efc4947U, 0x5c6bfb31U,
+            0x9e3779b1U, 0x85ebca77U, 0xc2b2ae3dU, 0x27d4eb2fU,
+            0x165667b1U, 0xd3a2646dU, 0xfd7046c5U, 0xb55a4f09U};
+        bloomBlock hashes;
+        memcpy(&hashes, salts, sizeof(hashes));
+        hashes *= key;
+        // The top 5 bits of every lane pick the bit to set in it
+        bloomBlock ones = {0};
+        ones += 1;
+        mask = ones << (hashes >> 27);
+        for (unsigned int lane = 0; lane < BLOOM_BLOCK_LANES; lane++) mask[lane] = htonl(mask[lane]);
+    }
+
+    // Picks the block of the key and the 32-bit key for its lanes with one hash.
+    // Keys may be strings or unsigned ints, hashed as in BloomFilter.
+    template <typename K>
+    void locate(const K &input, unsigned int &block, uint32_t &key) const {
+        uint64_t h1 = 0, h2 = 0;
+        BloomFilter::hashKey(input, h1, h2);
+        block = h1 % numBlocks;
+        key = (uint32_t)h2;
+    }
+
+    // Every bit of the mask of key must be set in the block
+    bool contains(unsigned int block, uint32_t key) const {
+        bloomBlock missing;
+        makeMask(key, missing);
+        missing &= ~blocks[block];
+        uint64_t words[BLOOM_BLOCK_BYTES / sizeof(uint64_t)];
+        memcpy(words, &missing, sizeof(words));
+        uint64_t any = 0;
+        for (unsigned int i = 0; i < BLOOM_BLOCK_BYTES / sizeof(uint64_t); i++) any |= words[i];
+        return !any;
+    }
+
+    void allocate(unsigned int nBlocks) {
+        numBlocks = nBlocks;
+        size = numBlocks * BLOOM_BLOCK_BYTES * BITS_IN_BYTE;
+        void *ptr = NULL;
+        if (posix_memalign(&ptr, BLOOM_BLOCK_BYTES, numBlocks * BLOOM_BLOCK_BYTES)) ptr = NULL;
+        blocks = (bloomBlock *)ptr;
+    }
+
+   public:
+    // A key sets one bit in each lane, so BLOOM_BLOCK_LANES is
+    // the only number of hash functions this filter has
+    static bool validFunctions(unsigned int functions) { return functions == BLOOM_BLOCK_LANES; }
+
+    // Input size is expected in bytes and it's rounded up to whole blocks.
+    // Only validFunctions are honoured, any other number is taken as BLOOM_BLOCK_LANES.
+    BlockedBloomFilter(unsigned int sz = 1000, int functions = BLOOM_BLOCK_LANES) {
+        unsigned int nBlocks = (sz + BLOOM_BLOCK_BYTES - 1) / BLOOM_BLOCK_BYTES;
+        allocate(nBlocks ? nBlocks : 1);
+        memset(blocks, 0, numBlocks * BLOOM_BLOCK_BYTES);
+    }
+    ~BlockedBloomFilter() { free(blocks); }
+
+    BlockedBloomFilter(const BlockedBloomFilter &filter) {
+        allocate(filter.numBlocks);
+        memcpy(blocks, filter.blocks, numBlocks * BLOOM_BLOCK_BYTES);
+    }
+
+    BlockedBloomFilter &operator=(const BlockedBloomFilter &filter) {
+        if (this == &filter) return *this;
+        if (numBlocks != filter.numBlocks) {
+            free(blocks);
+            allocate(filter.numBlocks);
+        }
+        memcpy(blocks, filter.blocks, numBlocks * BLOOM_BLOCK_BYTES);
+        return *this;
+    }
+
+    // The moved-from filter is left empty, without blocks
+    BlockedBloomFilter(BlockedBloomFilter &&filter)
+        : size(filter.size), numBlocks(filter.numBlocks), blocks(filter.blocks) {
+        filter.size = filter.numBlocks = 0;
+        filter.blocks = NULL;
+    }
+
+    BlockedBloomFilter &operator=(BlockedBloomFilter &&filter) {
+        if (this == &filter) return *this;
+        free(blocks);
+        size = filter.size;
+        numBlocks = filter.numBlocks;
+        blocks = filter.blocks;
+        filter.size = filter.numBlocks = 0;
+        filter.blocks = NULL;
+        return *this;
+    }
+
+    unsigned int getSize() const { return size; }
+    unsigned int getFunctionsNumber() const { return BLOOM_BLOCK_LANES; }
+    char *getArray() const { return (char *)blocks; }
+
+    template <typename K>
+    void insert(const K &input) {
+        unsigned int block = 0;
+        uint32_t key = 0;
+        locate(input, block, key);
+        bloomBlock mask;
+        makeMask(key, mask);
+        blocks[block] |= mask;
+    }
+
+    template <typename K>
+    bool check(const K &input) const {
+        unsigned int block = 0;
+        uint32_t key = 0;
+        locate(input, block, key);
+        return contains(block, key);
+    }
+
+    // Checks n keys at once and stores each answer in out, prefetching
+    // the blocks of a batch of keys before any of them is read
+    template <typename K>
+    void checkMany(const K *input, unsigned int n, bool *out) const {
+        unsigned int block[BLOOM_BATCH];
+        uint32_t key[BLOOM_BATCH];
+        for (unsigned int first = 0; first < n; first += BLOOM_BATCH) {
+            unsigned int batch = (n - first < BLOOM_BATCH) ? n - first : BLOOM_BATCH;
+            for (unsigned int k = 0; k < batch; k++) {
+                locate(input[first + k], block[k], key[k]);
+                __builtin_prefetch(&blocks[block[k]]);
+            }
+            for (unsigned int k = 0; k < batch; k++) out[first + k] = contains(block[k], key[k]);
+        }
+    }
+
+    // Overwrites the blocks with given array of the same size
+    void init(const char *array, unsigned int sz) {
+        if ((sz * BITS_IN_BYTE) != size) return;
+        memcpy(blocks, array, sz);
+    }
+
+    // Number of bits set in all the blocks
+    unsigned int countSetBits() const {
+        const bloomWord *words = (const bloomWord *)blocks;
+        unsigned int count = 0;
+        for (unsigned int w = 0; w < numBlocks * BLOOM_BLOCK_BYTES / sizeof(uint64_t); w++)
+            count += __builtin_popcountll(words[w]);
+        return count;
+    }
+
+    // Fraction of the bits that are set
+    double fillRatio() const { return size ? (double)countSetBits() / size : 0.0; }
+
+    // Prints the blocks bit by bit
+    void arrayStatus() const {
+        const unsigned char *bytes = (const unsigned char *)blocks;
+        for (unsigned int pos = 0; pos < size; pos++)
+            std::cout << ((bytes[pos / BITS_IN_BYTE] >> (pos % BITS_IN_BYTE)) & 1) << " ";
+        std::cout << std::endl;
+    }
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,55 @@
+#ifndef BLOOMDELTA_HPP
+#define BLOOMDELTA_HPP
+
+#include <arpa/inet.h>
+#include <stdint.h>
+
+#include <cstring>
+
+// A delta is the byte offset of a 64-bit word of a bloom filter array, in network
+// byte order, followed by the new value of that word, as the 8 bytes of the array
+// it covers. The last word of an array whose size is not a multiple of 8 bytes
+// is padded with zeros.
+#define BLOOM_DELTA_WORD sizeof(uint64_t)
+#define BLOOM_DELTA_SIZE (sizeof(uint32_t) + BLOOM_DELTA_WORD)
+
+// Size of the buffer that holds the deltas of every word of an array of given bytes
+inline unsigned int bloomDeltaCapacity(unsigned int bytes) {
+    return ((bytes + BLOOM_DELTA_WORD - 1) / BLOOM_DELTA_WORD) * BLOOM_DELTA_SIZE;
+}
+
+// Writes the pair of the word at given byte offset of an array of given bytes,
+// as the delta at position pos of deltas
+inline void bloomDeltaPut(char *deltas, unsigned int pos, uint32_t offset, const char *array, unsigned int bytes) {
+    uint64_t word = 0;
+    unsigned int len = (bytes - offset < BLOOM_DELTA_WORD) ? bytes - offset : BLOOM_DELTA_WORD;
+    memcpy(&word, array + offset, len);
+    uint32_t netOffset = htonl(offset);
+    memcpy(deltas + pos * BLOOM_DELTA_SIZE, &netOffset, sizeof(uint32_t));
+    memcpy(deltas + pos * BLOOM_DELTA_SIZE + sizeof(uint32_t), &word, BLOOM_DELTA_WORD);
+}
+
+// Writes in deltas one pair for every word that differs between the previous
+// and the current array of the same size, and returns the number of pairs
+inline unsigned int bloomDiff(const char *previous, const char *current, unsigned int bytes, char *deltas) {
+    unsigned int count = 0;
+    for (uint32_t offset = 0; offset < bytes; offset += BLOOM_DELTA_WORD) {
+        unsigned int len = (bytes - offset < BLOOM_DELTA_WORD) ? bytes - offset : BLOOM_DELTA_WORD;
+        if (memcmp(previous + offset, current + offset, len)) bloomDeltaPut(deltas, count++, offset, current, bytes);
+    }
+    return count;
+}
+
+// Overwrites the words of the array with count pairs of deltas
+inline void bloomPatch(char *array, unsigned int bytes, const char *deltas, unsigned int count) {
+    for (unsigned int d = 0; d < count; d++) {
+        uint32_t offset = 0;
+        memcpy(&offset, deltas + d * BLOOM_DELTA_SIZE, sizeof(uint32_t));
+        offset = ntohl(offset);
+        if (offset >= bytes) continue;
+        unsigned int len = (bytes - offset < BLOOM_DELTA_WORD) ? bytes - offset : BLOOM_DELTA_WORD;
+        memcpy(array + offset, deltas + d * BLOOM_DELTA_SIZE + sizeof(uint32_t), len);
+    }
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,76 @@
+#ifndef BLOOMENCODING_HPP
+#define BLOOMENCODING_HPP
+
+#include <stdint.h>
+
+#include <cstring>
+
+// Run-length encoding of sparse bloom filter arrays. The array is written as a
+// sequence of runs, each one made of the number of zero bytes, the number of
+// literal bytes that follow them and those literal bytes. Both counts are
+// varints of 7 bits per byte, the highest bit is set in all but the last byte.
+
+// Appends value as a varint at out[pos], if it fits before limit
+inline bool putVarint(uint32_t value, char *out, unsigned int &pos, unsigned int limit) {
+    do {
+        if (pos >= limit) return false;
+        unsigned char byte = value & 0x7f;
+        value >>= 7;
+        if (value) byte |= 0x80;
+        out[pos++] = byte;
+    } while (value);
+    return true;
+}
+
+// Reads a varint at in[pos], if it ends before len
+inline bool getVarint(const char *in, unsigned int &pos, unsigned int len, uint32_t &value) {
+    value = 0;
+    for (unsigned int shift = 0; shift < 32; shift += 7) {
+        if (pos >= len) return false;
+        unsigned char byte = in[pos++];
+        value |= (uint32_t)(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) return true;
+    }
+    return false;
+}
+
+// Encodes the array in out, which holds up to bytes - 1 bytes. Returns the
+// encoded length, or 0 if the encoding isn't smaller than the array itself.
+inline unsigned int bloomEncode(const char *array, unsigned int bytes, char *out) {
+    unsigned int pos = 0, in = 0, limit = bytes ? bytes - 1 : 0;
+    while (in < bytes) {
+        unsigned int zeros = 0, literals = 0;
+        while (in + zeros < bytes && !array[in + zeros]) zeros++;
+        in += zeros;
+        // A literal run ends at the next pair of zeros, as a single one
+        // costs less to copy than to start a new run for
+        while (in + literals < bytes &&
+               (array[in + literals] || (in + literals + 1 < bytes && array[in + literals + 1])))
+            literals++;
+        if (!putVarint(zeros, out, pos, limit) || !putVarint(literals, out, pos, limit)) return 0;
+        if (pos + literals > limit) return 0;
+        memcpy(out + pos, array + in, literals);
+        pos += literals;
+        in += literals;
+    }
+    return pos;
+}
+
+// Decodes len bytes of in to the array of given size. False if they are malformed.
+inline bool bloomDecode(const char *in, unsigned int len, char *array, unsigned int bytes) {
+    unsigned int pos = 0, out = 0;
+    uint32_t zeros = 0, literals = 0;
+    while (pos < len) {
+        if (!getVarint(in, pos, len, zeros) || !getVarint(in, pos, len, literals)) return false;
+        if (zeros > bytes - out || literals > bytes - out - zeros || literals > len - pos) return false;
+        memset(array + out, 0, zeros);
+        out += zeros;
+        memcpy(array + out, in + pos, literals);
+        out += literals;
+        pos += literals;
+    }
+    memset(array + out, 0, bytes - out);
+    return true;
+}
+
+#endif
\ No newline at end of file
@@ -4,18 +4,31 @@
 #define CHAR_SIZE (sizeof(char) * 8)  // bits
 #define BITS_IN_BYTE 8
 #define HASH_FUNCTIONS_NUMBER 16
+#define BLOOM_HASH_SEED 0x9747b28c
+#define BLOOM_MIN_BYTES 8
+#define BLOOM_MAX_BYTES (64 * 1024 * 1024)
+#define BLOOM_MAX_FUNCTIONS 32
+#define BLOOM_BATCH 16  // Keys whose probes are prefetched together by checkMany
 
+#include <stdint.h>
+
+#include <cmath>
 #include <cstring>
 #include <iostream>
 
 #include "hashFunctions.hpp"
 
+// A 64-bit word that may be read from any (even unaligned) char array
+typedef uint64_t bloomWord __attribute__((__may_alias__, __aligned__(1)));
+
 class BloomFilter {
    private:
     unsigned int size;  // in bits!
     unsigned int hashFunctionsNumber;
     char *bitArray;
 
+    unsigned int bytes() const { return size / BITS_IN_BYTE; }
+
     // Apply logical OR to the array with a mask (Mask Type: 0-0-0-0-0-0-0-0-1)
     void set(unsigned int pos) { bitArray[pos / CHAR_SIZE] |= (1 << pos % CHAR_SIZE); }
     // Apply logical AND to the array with a mask (Mask Type: 1-1-1-1-1-1-1-1-0)
@@ -24,64 +37,137 @@ class BloomFilter {
     bool checkBit(unsigned int pos) const { return ((bitArray[pos / CHAR_SIZE]) & (1 << pos % CHAR_SIZE)); }
 
    public:
+    // Hashes the key only once (shared with CountingBloomFilter). Every probe position is then derived from the
+    // two halves of the 128-bit hash with (enhanced) double hashing:
+    // position(i) = h1 + i * h2 + i * i, as in Kirsch & Mitzenmacher.
+    static void hashKey(const std::string &input, uint64_t &h1, uint64_t &h2) {
+        uint64_t hash[2];
+        murmur3_128(input.data(), input.length(), BLOOM_HASH_SEED, hash);
+        h1 = hash[0];
+        h2 = hash[1];
+    }
+
+    // Numeric keys, such as citizen IDs, skip formatting and hashing strings.
+    // Both halves come from the 64-bit finalizer of MurmurHash3, which fully
+    // mixes every input bit, so a key is hashed the same on every host.
+    static void hashKey(unsigned int input, uint64_t &h1, uint64_t &h2) {
+        h1 = fmix64((uint64_t)input ^ BLOOM_HASH_SEED);
+        h2 = fmix64(h1 ^ 0x9e3779b97f4a7c15ULL);
+    }
+
     // Input size of bitarray is expected in bytes, NOT bits
     BloomFilter(unsigned int sz = 1000, int functions = 16)
         : size(sz * BITS_IN_BYTE), hashFunctionsNumber(functions) {
         bitArray = new char[sz];  // Allocating in bytes!
-        for (unsigned int pos = 0; pos < size; pos++) reset(pos);
+        memset(bitArray, 0, sz);
     }
     ~BloomFilter() { delete[] bitArray; }
 
     BloomFilter(const BloomFilter &filter) {
-        if (this == &filter) return;
         size = filter.getSize();
-        delete[] bitArray;
         bitArray = new char[size / BITS_IN_BYTE];  // the size we copied was in bits!
         hashFunctionsNumber = filter.getFunctionsNumber();
-        for (unsigned int pos = 0; pos < size; pos++)
-            if (filter.checkBit(pos))
-                set(pos);
-            else
-                reset(pos);
+        memcpy(bitArray, filter.bitArray, bytes());
     }
 
     BloomFilter &operator=(const BloomFilter &filter) {
         if (this == &filter) return *this;
-        size = filter.getSize();
-        delete[] bitArray;
-        bitArray = new char[size / BITS_IN_BYTE];  // the size we copied was in bits!
+        // Reuse the current array when the sizes match
+        if (size != filter.getSize()) {
+            size = filter.getSize();
+            delete[] bitArray;
+            bitArray = new char[size / BITS_IN_BYTE];  // the size we copied was in bits!
+        }
         hashFunctionsNumber = filter.getFunctionsNumber();
-        for (unsigned int pos = 0; pos < size; pos++)
-            if (filter.checkBit(pos))
-                set(pos);
-            else
-                reset(pos);
+        memcpy(bitArray, filter.bitArray, bytes());
         return *this;
     }
 
+    // The moved-from filter is left empty, without a bitArray
+    BloomFilter(BloomFilter &&filter)
+        : size(filter.size), hashFunctionsNumber(filter.hashFunctionsNumber), bitArray(filter.bitArray) {
+        filter.size = 0;
+        filter.bitArray = NULL;
+    }
+
+    BloomFilter &operator=(BloomFilter &&filter) {
+        if (this == &filter) return *this;
+        delete[] bitArray;
+        size = filter.size;
+        hashFunctionsNumber = filter.hashFunctionsNumber;
+        bitArray = filter.bitArray;
+        filter.size = 0;
+        filter.bitArray = NULL;
+        return *this;
+    }
+
+    // Computes the optimal size in bytes and number of hash functions of a filter
+    // that holds expected keys with a false positive rate of at most fpr:
+    // m = -n * ln(p) / (ln2)^2 bits and k = (m / n) * ln2
+    static void optimalSize(unsigned int expected, double fpr, unsigned int &sz, unsigned int &functions) {
+        if (!expected) expected = 1;
+        double bits = -(double)expected * log(fpr) / (M_LN2 * M_LN2);
+        double bytes = ceil(bits / BITS_IN_BYTE);
+        sz = (bytes < BLOOM_MIN_BYTES) ? BLOOM_MIN_BYTES : (bytes > BLOOM_MAX_BYTES) ? BLOOM_MAX_BYTES : (unsigned int)bytes;
+        functions = (unsigned int)round(((double)sz * BITS_IN_BYTE / expected) * M_LN2);
+        if (functions < 1) functions = 1;
+        if (functions > BLOOM_MAX_FUNCTIONS) functions = BLOOM_MAX_FUNCTIONS;
+    }
+
+    // Whether a filter can use the given number of hash functions
+    static bool validFunctions(unsigned int functions) { return functions >= 1 && functions <= BLOOM_MAX_FUNCTIONS; }
+
     unsigned int getSize() const { return size; }
     unsigned int getFunctionsNumber() const { return hashFunctionsNumber; }
     char *getArray() const { return bitArray; }
 
-    void insert(const std::string &input) {
-        // Insert input if we know it's NOT already present
-        if (!check(input)) {
-            unsigned long hash = 0;
-            for (unsigned int pos = 0; pos < hashFunctionsNumber; pos++) {
-                hash = hash_i((unsigned char *)input.c_str(), pos);
-                set(hash % size);
-            }
+    // Keys may be strings or unsigned ints (see hashKey)
+    template <typename K>
+    void insert(const K &input) {
+        uint64_t h1 = 0, h2 = 0;
+        hashKey(input, h1, h2);
+        for (unsigned int i = 0; i < hashFunctionsNumber; i++) {
+            set(h1 % size);
+            h1 += h2 + 2 * i + 1;  // (i+1)^2 - i^2 = 2i + 1
         }
     }
 
-    bool check(const std::string &input) {
-        bool found = true;
-        unsigned long hash = 0;
-        for (unsigned int pos = 0; pos < hashFunctionsNumber; pos++) {
-            hash = hash_i((unsigned char *)input.c_str(), pos);
-            found = found && checkBit(hash % size);
+    template <typename K>
+    bool check(const K &input) const {
+        uint64_t h1 = 0, h2 = 0;
+        hashKey(input, h1, h2);
+        // Stop at the first bit that is not set
+        for (unsigned int i = 0; i < hashFunctionsNumber; i++) {
+            if (!checkBit(h1 % size)) return false;
+            h1 += h2 + 2 * i + 1;
+        }
+        return true;
+    }
+
+    // Checks n keys at once and stores each answer in out. The keys are hashed
+    // and all their probes are prefetched a batch at a time, before any of
+    // them is read, so that the cache misses of the batch overlap.
+    template <typename K>
+    void checkMany(const K *input, unsigned int n, bool *out) const {
+        uint64_t h1[BLOOM_BATCH], h2[BLOOM_BATCH];
+        for (unsigned int first = 0; first < n; first += BLOOM_BATCH) {
+            unsigned int batch = (n - first < BLOOM_BATCH) ? n - first : BLOOM_BATCH;
+            for (unsigned int key = 0; key < batch; key++) {
+                hashKey(input[first + key], h1[key], h2[key]);
+                uint64_t pos = h1[key];
+                for (unsigned int i = 0; i < hashFunctionsNumber; i++) {
+                    __builtin_prefetch(&bitArray[(pos % size) / CHAR_SIZE]);
+                    pos += h2[key] + 2 * i + 1;
+                }
+            }
+            for (unsigned int key = 0; key < batch; key++) {
+                out[first + key] = true;
+                for (unsigned int i = 0; i < hashFunctionsNumber; i++) {
+                    if (!checkBit(h1[key] % size)) { out[first + key] = false; break; }
+                    h1[key] += h2[key] + 2 * i + 1;
+                }
+            }
         }
-        return found;
     }
 
     // Overwrites the bitArray with given array of the same size
@@ -90,13 +176,19 @@ class BloomFilter {
         memcpy(bitArray, array, size / BITS_IN_BYTE);
     }
 
-    // Merges the bitArray with given array of the same size
-    void merge(const char *array, unsigned int sz) {
-        if ((sz * BITS_IN_BYTE) != size) return;
-        for (unsigned int pos = 0; pos < size; pos++)
-            bitArray[pos/CHAR_SIZE] |= array[pos/CHAR_SIZE];
+    // Number of bits set in the bitArray
+    unsigned int countSetBits() const {
+        unsigned int sz = bytes(), words = sz / sizeof(uint64_t), count = 0;
+        const bloomWord *src = (const bloomWord *)bitArray;
+        for (unsigned int w = 0; w < words; w++) count += __builtin_popcountll(src[w]);
+        for (unsigned int pos = words * sizeof(uint64_t); pos < sz; pos++)
+            count += __builtin_popcount((unsigned char)bitArray[pos]);
+        return count;
     }
 
+    // Fraction of the bits that are set
+    double fillRatio() const { return size ? (double)countSetBits() / size : 0.0; }
+
     // Prints the bitArray
     void arrayStatus() const {
         for (unsigned int pos = 0; pos < size; pos++)
@@ -0,0 +1,70 @@
+#ifndef CONNECTION_HPP
+#define CONNECTION_HPP
+
+#define CONNECTION_BUFFER_SIZE (64 * 1024)  // Bytes read ahead, and bytes of messages batched
+
+#include <sys/uio.h>
+
+#include "Messaging.hpp"
+
+// Buffered end of a socket that messages are written to and read from as
+// frames (see Messaging.hpp). Small messages are batched and sent together,
+// when the batch fills up, or before waiting for a message, since the other
+// end may have to answer them first. Every read takes whatever has arrived by then into
+// a ring buffer, so that many small messages cost a single call. Messages
+// larger than the buffers skip them and go straight to or from the socket.
+// Once the other end closes the connection, or it breaks, nothing more is sent
+// and readMessage returns NULL, so that the owner can tell and give it up.
+class Connection {
+   private:
+    int sock;
+    bool open;
+    // Ring buffer of the bytes read ahead: count of them, starting at head
+    char *ring;
+    unsigned int head, count;
+    // Frames that are waiting to be sent
+    char *batch;
+    unsigned int batched;
+    // The last message that was read
+    MessageBuffer message;
+
+    // Reads whatever has arrived in the free space of the ring
+    void fill();
+    // Takes exactly size bytes from the ring, or the socket once it's empty.
+    // False if the connection closed first.
+    bool take(char *data, unsigned int size);
+
+    // A socket has a single connection
+    Connection(const Connection &);
+    Connection &operator=(const Connection &);
+
+   public:
+    // Messages are first read into a buffer of given capacity, which grows as needed
+    Connection(int s, unsigned int messageCapacity);
+    ~Connection() { delete[] ring; delete[] batch; }
+
+    int getSocket() const { return sock; }
+    bool isOpen() const { return open; }
+
+    // Queues a message to be sent with the next batch
+    void writeMessage(const char *data, unsigned int size);
+    // Sends the messages that are queued, if any
+    void flush();
+    // True if a whole message has been read ahead already
+    bool hasMessage() const;
+    // True if readMessage can start without waiting: a whole message has
+    // been read ahead, or as much of a large one as the ring holds, or the
+    // connection is closed and readMessage would fail
+    bool messageReady() const { return !open || hasMessage() || count == CONNECTION_BUFFER_SIZE; }
+    // Reads ahead whatever has arrived, once the socket is known to be
+    // readable, so that it doesn't wait
+    void receive() { if (open && count < CONNECTION_BUFFER_SIZE) fill(); }
+    // Returns the next message, sending any queued messages first if it has
+    // to wait for it. The returned message, a string if it's text, is valid
+    // until the next one is read. NULL if the connection closed first, or if
+    // the frame is larger than MAX_MESSAGE_SIZE, which closes it as well.
+    char *readMessage();
+    unsigned int getMessageSize() const { return message.getSize(); }
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,219 @@
+#ifndef COUNTINGBLOOMFILTER_HPP
+#define COUNTINGBLOOMFILTER_HPP
+
+#define COUNTER_BITS 4
+#define COUNTERS_IN_BYTE (BITS_IN_BYTE / COUNTER_BITS)
+#define COUNTER_MAX 15  // A saturated counter is never decremented again
+
+#include <stdint.h>
+
+#include <cstring>
+#include <iostream>
+
+#include "BloomDelta.hpp"
+#include "BloomFilter.hpp"
+
+// Bloom filter with a 4-bit counter in place of every bit, packed two in a byte.
+// Keys can be removed as well as inserted, and the filter can be exported to
+// a plain BloomFilter of the same geometry: it probes the very same positions,
+// so the exported bit is set wherever the counter is not zero.
+// The words of the exported filter whose counters were touched since it
+// was last exported are marked dirty, so that only they are exported again.
+class CountingBloomFilter {
+   private:
+    unsigned int size;  // in counters, the bits of the exported filter
+    unsigned int hashFunctionsNumber;
+    unsigned char *counters;
+    uint64_t *dirty;  // A bit for every BLOOM_DELTA_WORD of the exported filter
+    unsigned int dirtyWords;
+
+    unsigned int bytes() const { return size / COUNTERS_IN_BYTE; }
+    // Words of the exported filter, the last one of which may be partial
+    unsigned int words() const { return (size / BITS_IN_BYTE + BLOOM_DELTA_WORD - 1) / BLOOM_DELTA_WORD; }
+    unsigned int dirtyBytes() const { return ((words() + 63) / 64) * sizeof(uint64_t); }
+
+    void allocate() {
+        counters = new unsigned char[bytes()];
+        dirty = new uint64_t[dirtyBytes() / sizeof(uint64_t)];
+    }
+
+    // Marks the word of the exported filter that holds the bit of a counter
+    void touch(unsigned int pos) {
+        unsigned int word = pos / (BLOOM_DELTA_WORD * BITS_IN_BYTE);
+        uint64_t bit = 1ULL << (word % 64);
+        if (dirty[word / 64] & bit) return;
+        dirty[word / 64] |= bit;
+        dirtyWords++;
+    }
+
+    // The byte at given position of the exported filter, from its 8 counters
+    unsigned char exportByte(unsigned int pos) const {
+        unsigned char bits = 0;
+        for (unsigned int bit = 0; bit < BITS_IN_BYTE; bit++)
+            if (get(pos * BITS_IN_BYTE + bit)) bits |= 1 << bit;
+        return bits;
+    }
+
+    unsigned int get(unsigned int pos) const {
+        return (counters[pos / COUNTERS_IN_BYTE] >> (pos % COUNTERS_IN_BYTE) * COUNTER_BITS) & COUNTER_MAX;
+    }
+    void increment(unsigned int pos) {
+        if (get(pos) == COUNTER_MAX) return;
+        counters[pos / COUNTERS_IN_BYTE] += 1 << (pos % COUNTERS_IN_BYTE) * COUNTER_BITS;
+    }
+    void decrement(unsigned int pos) {
+        unsigned int value = get(pos);
+        if (!value || value == COUNTER_MAX) return;
+        counters[pos / COUNTERS_IN_BYTE] -= 1 << (pos % COUNTERS_IN_BYTE) * COUNTER_BITS;
+    }
+
+   public:
+    // Input size is the size in bytes of the exported BloomFilter
+    CountingBloomFilter(unsigned int sz = 1000, int functions = 16)
+        : size(sz * BITS_IN_BYTE), hashFunctionsNumber(functions) {
+        allocate();
+        memset(counters, 0, bytes());
+        clearDirty();
+    }
+    ~CountingBloomFilter() {
+        delete[] counters;
+        delete[] dirty;
+    }
+
+    CountingBloomFilter(const CountingBloomFilter &filter)
+        : size(filter.size), hashFunctionsNumber(filter.hashFunctionsNumber), dirtyWords(filter.dirtyWords) {
+        allocate();
+        memcpy(counters, filter.counters, bytes());
+        memcpy(dirty, filter.dirty, dirtyBytes());
+    }
+
+    CountingBloomFilter &operator=(const CountingBloomFilter &filter) {
+        if (this == &filter) return *this;
+        if (size != filter.size) {
+            size = filter.size;
+            delete[] counters;
+            delete[] dirty;
+            allocate();
+        }
+        hashFunctionsNumber = filter.hashFunctionsNumber;
+        memcpy(counters, filter.counters, bytes());
+        memcpy(dirty, filter.dirty, dirtyBytes());
+        dirtyWords = filter.dirtyWords;
+        return *this;
+    }
+
+    // The moved-from filter is left empty, without counters
+    CountingBloomFilter(CountingBloomFilter &&filter)
+        : size(filter.size), hashFunctionsNumber(filter.hashFunctionsNumber), counters(filter.counters),
+          dirty(filter.dirty), dirtyWords(filter.dirtyWords) {
+        filter.size = filter.dirtyWords = 0;
+        filter.counters = NULL;
+        filter.dirty = NULL;
+    }
+
+    CountingBloomFilter &operator=(CountingBloomFilter &&filter) {
+        if (this == &filter) return *this;
+        delete[] counters;
+        delete[] dirty;
+        size = filter.size;
+        hashFunctionsNumber = filter.hashFunctionsNumber;
+        counters = filter.counters;
+        dirty = filter.dirty;
+        dirtyWords = filter.dirtyWords;
+        filter.size = filter.dirtyWords = 0;
+        filter.counters = NULL;
+        filter.dirty = NULL;
+        return *this;
+    }
+
+    unsigned int getSize() const { return size; }
+    unsigned int getFunctionsNumber() const { return hashFunctionsNumber; }
+    // Words of the exported filter that may have changed since it was last exported
+    unsigned int getDirtyWords() const { return dirtyWords; }
+
+    // Keys may be strings or unsigned ints, hashed as in BloomFilter
+    template <typename K>
+    void insert(const K &input) {
+        uint64_t h1 = 0, h2 = 0;
+        BloomFilter::hashKey(input, h1, h2);
+        for (unsigned int i = 0; i < hashFunctionsNumber; i++) {
+            increment(h1 % size);
+            touch(h1 % size);
+            h1 += h2 + 2 * i + 1;
+        }
+    }
+
+    // Only keys that were inserted must be removed, otherwise the
+    // counters of other keys are decremented and they may get lost
+    template <typename K>
+    void remove(const K &input) {
+        if (!check(input)) return;
+        uint64_t h1 = 0, h2 = 0;
+        BloomFilter::hashKey(input, h1, h2);
+        for (unsigned int i = 0; i < hashFunctionsNumber; i++) {
+            decrement(h1 % size);
+            touch(h1 % size);
+            h1 += h2 + 2 * i + 1;
+        }
+    }
+
+    template <typename K>
+    bool check(const K &input) const {
+        uint64_t h1 = 0, h2 = 0;
+        BloomFilter::hashKey(input, h1, h2);
+        for (unsigned int i = 0; i < hashFunctionsNumber; i++) {
+            if (!get(h1 % size)) return false;
+            h1 += h2 + 2 * i + 1;
+        }
+        return true;
+    }
+
+    // Writes the plain filter into given BloomFilter, which is reallocated
+    // if its size or number of hash functions doesn't match
+    void exportTo(BloomFilter &filter) {
+        if (filter.getSize() != size || filter.getFunctionsNumber() != hashFunctionsNumber)
+            filter = BloomFilter(size / BITS_IN_BYTE, hashFunctionsNumber);
+        char *bitArray = filter.getArray();
+        // Every pair of counter bytes gives a byte of bits
+        for (unsigned int pos = 0; pos < size / BITS_IN_BYTE; pos++) bitArray[pos] = exportByte(pos);
+        clearDirty();
+    }
+
+    // Brings the given filter, which this one was last exported to, up to date
+    // by exporting its dirty words only. Every word that changed is written in
+    // deltas as well, which must have room for getDirtyWords() of them, and
+    // their number is returned (see BloomDelta.hpp).
+    unsigned int exportChanges(BloomFilter &filter, char *deltas) {
+        unsigned int sz = size / BITS_IN_BYTE, count = 0;
+        char *bitArray = filter.getArray();
+        for (unsigned int d = 0; dirtyWords && d < dirtyBytes() / sizeof(uint64_t); d++) {
+            for (uint64_t marks = dirty[d]; marks; marks &= marks - 1) {
+                uint32_t offset = (d * 64 + __builtin_ctzll(marks)) * BLOOM_DELTA_WORD;
+                bool changed = false;
+                for (unsigned int pos = offset; pos < offset + BLOOM_DELTA_WORD && pos < sz; pos++) {
+                    char bits = exportByte(pos);
+                    if (bitArray[pos] != bits) changed = true;
+                    bitArray[pos] = bits;
+                }
+                if (changed) bloomDeltaPut(deltas, count++, offset, bitArray, sz);
+            }
+        }
+        clearDirty();
+        return count;
+    }
+
+    // Forgets the dirty words, for a filter that is exported some other way
+    void clearDirty() {
+        memset(dirty, 0, dirtyBytes());
+        dirtyWords = 0;
+    }
+
+    // Prints the counters
+    void arrayStatus() const {
+        for (unsigned int pos = 0; pos < size; pos++)
+            std::cout << get(pos) << " ";
+        std::cout << std::endl;
+    }
+};
+
+#endif
\ No newline at end of file
@@ -44,7 +44,7 @@ inline void splitLine(std::string &str, List<std::string> &args, char delim = '
             len++;
         }
         result = str.substr(pos - len, len);
-        args.insertLast(result);
+        args.insertLast(std::move(result));
         if (str[pos] != '\0') pos++;
     }
 }
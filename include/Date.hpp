@@ -1,6 +1,8 @@
 #ifndef DATE_HPP
 #define DATE_HPP
 
+#include <stdint.h>
+
 #include <cstdlib>
 #include <ctime>
 #include <iostream>
@@ -70,6 +72,14 @@ class Date {
             day = month = year = 0;
     }
 
+    // The date in 32 bits, as it's sent in binary messages. No valid date packs to 0.
+    uint32_t pack() const { return (uint32_t)year << 9 | month << 5 | day; }
+    void unpack(uint32_t packed) {
+        day = packed & 0x1f;
+        month = packed >> 5 & 0xf;
+        year = packed >> 9;
+    }
+
     int daysDifference(const Date &date) const {
         int dayDiff = 0, monthDiff = 0, yearDiff = 0;
         dayDiff = this->day - date.day;
@@ -0,0 +1,33 @@
+#ifndef EVENTLOOP_HPP
+#define EVENTLOOP_HPP
+
+#define EVENT_LOOP_MAX_EVENTS 64  // Returned by a single wait
+
+#include <sys/epoll.h>
+
+// Waits on many sockets at once with epoll, so that the work of many peers
+// goes on at the same time and takes as long as the slowest of them, not
+// as long as all of them together. Every socket is watched along with a
+// pointer, which is given back when the socket is ready.
+class EventLoop {
+   private:
+    int epfd;
+
+    // An epoll instance is owned by a single loop
+    EventLoop(const EventLoop &);
+    EventLoop &operator=(const EventLoop &);
+
+   public:
+    EventLoop();
+    ~EventLoop();
+
+    // Events are EPOLLIN for input, EPOLLOUT for a connect that completed
+    void watch(int sock, uint32_t events, void *data);
+    void unwatch(int sock);
+    // Waits up to timeout milliseconds, or forever if it's -1, for some of the
+    // sockets to be ready, and stores their pointers in ready. Returns their
+    // number, which is 0 if the time ran out or a signal came first.
+    unsigned int wait(void **ready, unsigned int maxReady, int timeout);
+};
+
+#endif
\ No newline at end of file
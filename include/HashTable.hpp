@@ -1,6 +1,8 @@
 #ifndef HASHTABLE_HPP
 #define HASHTABLE_HPP
 
+#include <utility>
+
 #include "List.hpp"
 #include "hashFunctions.hpp"
 
@@ -13,7 +15,7 @@ class HashTable {
     unsigned int totalEntries;
     List<T> *table;  // Array of collision buckets used for the chains
 
-    unsigned long hashFunction(std::string key) {
+    unsigned long hashFunction(const std::string &key) const {
         return hash_i((unsigned char *)key.c_str(), key.length()) % size;
     }
 
@@ -22,31 +24,40 @@ class HashTable {
         : size(capacity), totalEntries(0) { table = new List<T>[size]; }
     ~HashTable() { delete[] table; }
     HashTable (const HashTable &t);
+    HashTable(HashTable &&t);
     HashTable &operator=(const HashTable &t);
+    HashTable &operator=(HashTable &&t);
 
     unsigned int getSize() const { return size; }
     unsigned int getTotalEntries() const { return totalEntries; }
 
-    void insert(std::string key, T node);
-    void remove(std::string key, T node);
+    void insert(const std::string &key, const T &node);
+    void insert(const std::string &key, T &&node);
+    // Constructs the new entry in its bucket from the given arguments
+    template <typename... Args>
+    void emplace(const std::string &key, Args &&...args);
+    void remove(const std::string &key, const T &node);
 
-    T *search(std::string key, T node);
-    List<T> getBucket(std::string key);
+    T *search(const std::string &key, const T &node);
+    List<T> getBucket(const std::string &key);
     void print() const;
 };
 
 template <typename T>
-HashTable<T>::HashTable(const HashTable<T> &t) {
-    if (this == &t) return;
-    for (unsigned int bucket = 0; bucket < size; bucket++)
-        table[bucket].flush();
-    delete[] table;
-    size = t.getSize();
-    totalEntries = t.getTotalEntries();
+HashTable<T>::HashTable(const HashTable<T> &t)
+    : size(t.getSize()), totalEntries(t.getTotalEntries()) {
     table = new List<T>[size];
     for (unsigned int bucket = 0; bucket < size; bucket++)
         table[bucket] = t.table[bucket];
-    return;
+}
+
+// The moved-from table is left with a single empty bucket
+template <typename T>
+HashTable<T>::HashTable(HashTable<T> &&t)
+    : size(t.size), totalEntries(t.totalEntries), table(t.table) {
+    t.size = 1;
+    t.totalEntries = 0;
+    t.table = new List<T>[t.size];
 }
 
 template <typename T>
@@ -64,21 +75,53 @@ HashTable<T> &HashTable<T>::operator=(const HashTable<T> &t) {
 }
 
 template <typename T>
-void HashTable<T>::insert(std::string key, T node) {
+HashTable<T> &HashTable<T>::operator=(HashTable<T> &&t) {
+    if (this == &t) return *this;
+    // Swap the buckets so that t releases the old ones
+    List<T> *tempTable = table;
+    unsigned int tempSize = size;
+    table = t.table;
+    size = t.size;
+    totalEntries = t.totalEntries;
+    t.table = tempTable;
+    t.size = tempSize;
+    for (unsigned int bucket = 0; bucket < t.size; bucket++)
+        t.table[bucket].flush();
+    t.totalEntries = 0;
+    return *this;
+}
+
+template <typename T>
+void HashTable<T>::insert(const std::string &key, const T &node) {
     unsigned long index = hashFunction(key);
     table[index].insertFirst(node);
     totalEntries++;
 }
 
 template <typename T>
-void HashTable<T>::remove(std::string key, T node) {
+void HashTable<T>::insert(const std::string &key, T &&node) {
+    unsigned long index = hashFunction(key);
+    table[index].insertFirst(std::move(node));
+    totalEntries++;
+}
+
+template <typename T>
+template <typename... Args>
+void HashTable<T>::emplace(const std::string &key, Args &&...args) {
+    unsigned long index = hashFunction(key);
+    table[index].emplaceFirst(std::forward<Args>(args)...);
+    totalEntries++;
+}
+
+template <typename T>
+void HashTable<T>::remove(const std::string &key, const T &node) {
     unsigned long index = hashFunction(key);
     table[index].popValue(node);
     totalEntries--;
 }
 
 template <typename T>
-T *HashTable<T>::search(std::string key, T node) {
+T *HashTable<T>::search(const std::string &key, const T &node) {
     unsigned long index = hashFunction(key);
     T *temp = NULL;
     temp = table[index].search(node);
@@ -86,7 +129,7 @@ T *HashTable<T>::search(std::string key, T node) {
 }
 
 template <typename T>
-List<T> HashTable<T>::getBucket(std::string key) {
+List<T> HashTable<T>::getBucket(const std::string &key) {
     unsigned long index = hashFunction(key);
     return table[index];
 }
@@ -2,6 +2,7 @@
 #define LIST_HPP
 
 #include <iostream>
+#include <utility>
 
 template <typename T>
 class List {
@@ -9,42 +10,58 @@ class List {
     struct listNode {
         T data;
         listNode *next;
+        template <typename... Args>
+        listNode(Args &&...args) : data(std::forward<Args>(args)...), next(NULL) {}
     };
     unsigned int size;
     listNode *head;
     listNode *tail;
 
-    listNode *createNode(T data) {
-        listNode *node = new listNode();
-        node->data = data;
-        return node;
+    template <typename... Args>
+    listNode *createNode(Args &&...args) {
+        return new listNode(std::forward<Args>(args)...);
     }
 
-    // Copies the given list recursively so that
+    // Copies the given list node by node so that
     // the final form is identical with the original
-    void recCopy(listNode *node) {
-        if (node) {
-            recCopy(node->next);
-            insertFirst(node->data);
-        }
+    void copyNodes(listNode *node) {
+        for (; node; node = node->next)
+            insertLast(node->data);
     }
 
+    // Link an already created node in the appropriate position
+    void linkFirst(listNode *node);
+    void linkLast(listNode *node);
+    void linkAscending(listNode *node);
+    void linkDescending(listNode *node);
+
    public:
     List() : size(0), head(NULL), tail(NULL) {}
     List(const List &l);
+    List(List &&l);
     ~List() { flush(); }
     List &operator=(const List &l);
+    List &operator=(List &&l);
     unsigned int getSize() const { return size; }
     T &getFirst() { return head->data; }
     T &getLast() { return tail->data; }
 
-    void insertFirst(const T data);
-    void insertLast(const T data);
-    void insertAscending(const T data);
-    void insertDescending(const T data);
+    void insertFirst(const T &data) { linkFirst(createNode(data)); }
+    void insertFirst(T &&data) { linkFirst(createNode(std::move(data))); }
+    void insertLast(const T &data) { linkLast(createNode(data)); }
+    void insertLast(T &&data) { linkLast(createNode(std::move(data))); }
+    void insertAscending(const T &data) { linkAscending(createNode(data)); }
+    void insertAscending(T &&data) { linkAscending(createNode(std::move(data))); }
+    void insertDescending(const T &data) { linkDescending(createNode(data)); }
+    void insertDescending(T &&data) { linkDescending(createNode(std::move(data))); }
+    // Construct the new element in place from the given arguments
+    template <typename... Args>
+    void emplaceFirst(Args &&...args) { linkFirst(createNode(std::forward<Args>(args)...)); }
+    template <typename... Args>
+    void emplaceLast(Args &&...args) { linkLast(createNode(std::forward<Args>(args)...)); }
     void popFirst();
     void popLast();
-    void popValue(T data);
+    void popValue(const T &data);
 
     List<T> &sortAscending();
     List<T> &sortDescending();
@@ -57,28 +74,44 @@ class List {
 
     void print() const;
     T *getNode(unsigned int pos);
-    T *search(const T data) const;
+    T *search(const T &data) const;
     bool contains(const T &data) const;
 };
 
 template <typename T>
 List<T>::List(const List<T> &l) : size(0), head(NULL), tail(NULL) {
     if (this==&l) return;
-    flush();
-    recCopy(l.head);
+    copyNodes(l.head);
+}
+
+template <typename T>
+List<T>::List(List<T> &&l) : size(l.size), head(l.head), tail(l.tail) {
+    l.size = 0;
+    l.head = l.tail = NULL;
 }
 
 template <typename T>
 List<T> &List<T>::operator=(const List<T> &l) {
     if (this == &l) return *this;
     flush();
-    recCopy(l.head);
+    copyNodes(l.head);
+    return *this;
+}
+
+template <typename T>
+List<T> &List<T>::operator=(List<T> &&l) {
+    if (this == &l) return *this;
+    flush();
+    size = l.size;
+    head = l.head;
+    tail = l.tail;
+    l.size = 0;
+    l.head = l.tail = NULL;
     return *this;
 }
 
 template <typename T>
-void List<T>::insertFirst(T data) {
-    listNode *node = createNode(data);
+void List<T>::linkFirst(listNode *node) {
     if (!this->head) {
         node->next = NULL;
         this->tail = node;
@@ -90,8 +123,7 @@ void List<T>::insertFirst(T data) {
 }
 
 template <typename T>
-void List<T>::insertLast(T data) {
-    listNode *node = createNode(data);
+void List<T>::linkLast(listNode *node) {
     if (!this->head) {
         this->head = node;
     } else {
@@ -102,15 +134,15 @@ void List<T>::insertLast(T data) {
 }
 
 template <typename T>
-void List<T>::insertAscending(T data) {
+void List<T>::linkAscending(listNode *node) {
+    const T &data = node->data;
     if (empty() || this->head->data >= data) {
-        insertFirst(data);
+        linkFirst(node);
     } else if (this->tail->data <= data) {
-        insertLast(data);
+        linkLast(node);
     } else if (this->size == 1) {
-        (this->head->data >= data) ? insertFirst(data) : insertLast(data);
+        (this->head->data >= data) ? linkFirst(node) : linkLast(node);
     } else {
-        listNode *node = createNode(data);
         listNode *current = this->head;
         listNode *next = current->next;
         for (; next->data < data; next = current->next)
@@ -122,15 +154,15 @@ void List<T>::insertAscending(T data) {
 }
 
 template <typename T>
-void List<T>::insertDescending(T data) {
+void List<T>::linkDescending(listNode *node) {
+    const T &data = node->data;
     if (empty() || this->head->data < data) {
-        insertFirst(data);
+        linkFirst(node);
     } else if (this->tail->data > data) {
-        insertLast(data);
+        linkLast(node);
     } else if (this->size == 1) {
-        (this->head->data < data) ? insertFirst(data) : insertLast(data);
+        (this->head->data < data) ? linkFirst(node) : linkLast(node);
     } else {
-        listNode *node = createNode(data);
         listNode *current = this->head;
         listNode *next = current->next;
         for (; next->data >= data; next = current->next)
@@ -174,7 +206,7 @@ void List<T>::popLast() {
 }
 
 template <typename T>
-void List<T>::popValue(T data) {
+void List<T>::popValue(const T &data) {
     if (empty() || !search(data)) return;
     if (this->head->data == data) {
         popFirst();
@@ -199,8 +231,7 @@ List<T> &List<T>::sortAscending() {
     listNode *temp = this->head;
     for (; temp; temp = temp->next)
         newList.insertAscending(temp->data);
-    this->flush();
-    this->recCopy(newList.head);
+    *this = std::move(newList);
     return *this;
 }
 
@@ -246,7 +277,7 @@ T *List<T>::getNode(unsigned int pos) {
 }
 
 template <typename T>
-T *List<T>::search(const T data) const {
+T *List<T>::search(const T &data) const {
     if (empty()) return NULL;
     listNode *temp = this->head;
     T *ptr = NULL;
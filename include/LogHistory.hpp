@@ -5,7 +5,9 @@
 
 #include "List.hpp"
 
+// Any given extra lines are written after the request counters
 void writeLogFile(List<std::string> countryList, std::string dirName,
-                  mode_t permissions, unsigned int acc, unsigned int rej);
+                  mode_t permissions, unsigned int acc, unsigned int rej,
+                  const std::string &extra = "");
 
 #endif
\ No newline at end of file
@@ -1,7 +1,40 @@
 #ifndef MESSAGING_HPP
 #define MESSAGING_HPP
 
-void sendPackets(int fdWrite, const char *data, unsigned int msgSize, unsigned int buffSize);
-char *receivePackets(int fdRead, unsigned int buffSize);
+#include <stdint.h>
+
+// Every message travels as a frame: its length as a 32-bit unsigned int
+// in network byte order, immediately followed by the message itself
+#define FRAME_HEADER_SIZE sizeof(uint32_t)
+// Frames that claim to be larger are taken for garbage, and end the connection
+#define MAX_MESSAGE_SIZE (64 * 1024 * 1024)
+
+// Growable buffer that the received messages are read into. It's reused from
+// message to message, so it's only reallocated for a message larger than any before.
+class MessageBuffer {
+   private:
+    char *data;
+    unsigned int size;  // of the last message
+    unsigned int capacity;
+
+    // A buffer is owned by a single reader
+    MessageBuffer(const MessageBuffer &);
+    MessageBuffer &operator=(const MessageBuffer &);
+
+   public:
+    MessageBuffer(unsigned int initialCapacity = 64)
+        : data(new char[initialCapacity ? initialCapacity : 1]), size(0),
+          capacity(initialCapacity ? initialCapacity : 1) {}
+    ~MessageBuffer() { delete[] data; }
+
+    char *getData() const { return data; }
+    unsigned int getSize() const { return size; }
+    unsigned int getCapacity() const { return capacity; }
+
+    // Makes room for a message of given size, doubling the capacity as needed
+    // without ever overflowing it
+    void reserve(unsigned int sz);
+    void setSize(unsigned int sz) { size = sz; }
+};
 
 #endif
\ No newline at end of file
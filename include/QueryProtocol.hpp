@@ -0,0 +1,93 @@
+#ifndef QUERYPROTOCOL_HPP
+#define QUERYPROTOCOL_HPP
+
+#include <stdint.h>
+
+#include <cstring>
+
+// Binary messages of the queries that the travelClient sends to the monitors
+// and of their answers. Every message starts with its opcode and has a fixed
+// layout, with every field in network byte order, so it's encoded and decoded
+// with a copy. Viruses are given by the id the monitor interned them with,
+// which it sends along with their bloom filters, and dates are packed (see
+// Date::pack). The bloom filters themselves are still sent as before.
+enum queryOpcodes {
+    QUERY_EXIT = 0,
+    QUERY_TRAVEL_REQUEST = 1,
+    QUERY_TRAVEL_RESULT = 2,   // Whether a request was accepted at last, with no answer
+    QUERY_ADD_RECORDS = 3,
+    QUERY_SEARCH_STATUS = 4,
+    ANSWER_TRAVEL_REQUEST = 5,
+    ANSWER_SEARCH_STATUS = 6,
+    ANSWER_UPDATE = 7,         // New records were read, the bloom filters follow
+    ANSWER_NOT_FOUND = 8,
+    QUERY_SHUTDOWN = 9         // Exits, and the monitor accepts no more clients
+};
+
+// QUERY_EXIT, QUERY_SHUTDOWN, QUERY_ADD_RECORDS, ANSWER_UPDATE
+// and ANSWER_NOT_FOUND have no fields
+struct queryHeader {
+    uint8_t opcode;
+} __attribute__((packed));
+
+struct travelQuery {
+    uint8_t opcode;  // QUERY_TRAVEL_REQUEST
+    uint8_t reserved;
+    uint16_t virusID;
+    uint32_t requestID;  // Sent back with the answer
+    uint32_t citizenID;
+} __attribute__((packed));
+
+struct travelResult {
+    uint8_t opcode;  // QUERY_TRAVEL_RESULT
+    uint8_t accepted;
+} __attribute__((packed));
+
+struct travelAnswer {
+    uint8_t opcode;  // ANSWER_TRAVEL_REQUEST
+    uint8_t vaccinated;
+    uint16_t reserved;
+    uint32_t requestID;
+    uint32_t date;  // Of the vaccination
+} __attribute__((packed));
+
+struct statusQuery {
+    uint8_t opcode;  // QUERY_SEARCH_STATUS
+    uint8_t reserved[3];
+    uint32_t citizenID;
+} __attribute__((packed));
+
+// Unless found is 0, it's followed by the date of vaccination for every virus,
+// 0 if there's none, then the first name, last name and country of the
+// citizen and the names of the viruses, each one terminated by '\0'
+struct statusAnswer {
+    uint8_t opcode;  // ANSWER_SEARCH_STATUS
+    uint8_t found;
+    uint16_t numViruses;
+    uint32_t citizenID;
+    uint32_t age;
+} __attribute__((packed));
+
+// Opcode of a received message, or -1 if it's empty
+inline int messageOpcode(const char *data, unsigned int size) {
+    return size ? (uint8_t)data[0] : -1;
+}
+
+// Copies a received message into its struct. False if it's too short for it.
+template <typename M>
+inline bool decodeMessage(const char *data, unsigned int size, M &message) {
+    if (size < sizeof(M)) return false;
+    memcpy(&message, data, sizeof(M));
+    return true;
+}
+
+// Returns the string at pos, if it ends before end, and moves pos past it
+inline const char *nextString(const char *&pos, const char *end) {
+    const char *str = pos;
+    const char *terminator = (pos < end) ? (const char *)memchr(pos, '\0', end - pos) : NULL;
+    if (!terminator) return NULL;
+    pos = terminator + 1;
+    return str;
+}
+
+#endif
\ No newline at end of file
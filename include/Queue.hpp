@@ -1,32 +1,142 @@
 #ifndef QUEUE_HPP
 #define QUEUE_HPP
 
-#include "List.hpp"
+#include <atomic>
+#include <iostream>
+#include <utility>
 
+// Fixed-capacity FIFO queue on a circular array.
+// All the slots are allocated once, so enqueue/dequeue never allocate.
 template <typename T>
 class Queue {
    private:
     unsigned int maxSize;
-    List<T> qNodes;
+    unsigned int size;
+    unsigned int head;  // Position of the oldest element
+    unsigned int tail;  // Position where the next element will be placed
+    T *buffer;
+
+    unsigned int next(unsigned int pos) const { return (pos + 1 == maxSize) ? 0 : pos + 1; }
+
    public:
-    Queue(unsigned int maxSz) : maxSize(maxSz) {}
-    ~Queue() { T data; while(!empty()) dequeue(data); }
+    Queue(unsigned int maxSz) : maxSize(maxSz ? maxSz : 1), size(0), head(0), tail(0) {
+        buffer = new T[maxSize];
+    }
+    ~Queue() { delete[] buffer; }
+    Queue(const Queue &q);
+    Queue &operator=(const Queue &q);
 
-    bool empty() const { return qNodes.empty(); }
-    bool full() const { return qNodes.getSize() == maxSize; }
+    unsigned int getSize() const { return size; }
+    unsigned int getCapacity() const { return maxSize; }
+    bool empty() const { return !size; }
+    bool full() const { return size == maxSize; }
 
     bool enqueue(const T &data) {
         if (full()) return false;
-        qNodes.insertLast(data);
+        buffer[tail] = data;
+        tail = next(tail);
+        size++;
+        return true;
+    }
+    bool enqueue(T &&data) {
+        if (full()) return false;
+        buffer[tail] = std::move(data);
+        tail = next(tail);
+        size++;
         return true;
     }
+    // Moves the oldest element out of the queue
     bool dequeue(T &data) {
         if (empty()) return false;
-        data = qNodes.getFirst();
-        qNodes.popFirst();
+        data = std::move(buffer[head]);
+        head = next(head);
+        size--;
+        return true;
+    }
+    void print() const;
+};
+
+template <typename T>
+Queue<T>::Queue(const Queue<T> &q)
+    : maxSize(q.maxSize), size(q.size), head(0), tail(q.size % q.maxSize) {
+    buffer = new T[maxSize];
+    for (unsigned int i = 0, pos = q.head; i < q.size; i++, pos = q.next(pos))
+        buffer[i] = q.buffer[pos];
+}
+
+template <typename T>
+Queue<T> &Queue<T>::operator=(const Queue<T> &q) {
+    if (this == &q) return *this;
+    delete[] buffer;
+    maxSize = q.maxSize;
+    size = q.size;
+    head = 0;
+    tail = q.size % q.maxSize;
+    buffer = new T[maxSize];
+    for (unsigned int i = 0, pos = q.head; i < q.size; i++, pos = q.next(pos))
+        buffer[i] = q.buffer[pos];
+    return *this;
+}
+
+template <typename T>
+void Queue<T>::print() const {
+    if (empty()) return;
+    unsigned int pos = head;
+    for (unsigned int i = 0; i < size - 1; i++, pos = next(pos))
+        std::cout << buffer[pos] << " ==> ";
+    std::cout << buffer[pos] << std::endl;
+}
+
+// Lock-free variant of Queue for exactly one producer and one consumer thread.
+// The producer only writes tail and the consumer only writes head, so the two
+// sides synchronize through acquire/release on the opposite index alone.
+template <typename T>
+class SPSCQueue {
+   private:
+    unsigned int slots;  // One slot is always left empty to tell full from empty
+    T *buffer;
+    std::atomic<unsigned int> head;
+    std::atomic<unsigned int> tail;
+
+    unsigned int next(unsigned int pos) const { return (pos + 1 == slots) ? 0 : pos + 1; }
+
+    SPSCQueue(const SPSCQueue &q);
+    SPSCQueue &operator=(const SPSCQueue &q);
+
+   public:
+    SPSCQueue(unsigned int maxSz) : slots((maxSz ? maxSz : 1) + 1), head(0), tail(0) {
+        buffer = new T[slots];
+    }
+    ~SPSCQueue() { delete[] buffer; }
+
+    unsigned int getCapacity() const { return slots - 1; }
+    // Only exact when called by either the producer or the consumer
+    bool empty() const { return head.load(std::memory_order_acquire) == tail.load(std::memory_order_acquire); }
+    bool full() const { return next(tail.load(std::memory_order_acquire)) == head.load(std::memory_order_acquire); }
+
+    // Producer side
+    bool enqueue(const T &data) {
+        unsigned int pos = tail.load(std::memory_order_relaxed);
+        if (next(pos) == head.load(std::memory_order_acquire)) return false;
+        buffer[pos] = data;
+        tail.store(next(pos), std::memory_order_release);
+        return true;
+    }
+    bool enqueue(T &&data) {
+        unsigned int pos = tail.load(std::memory_order_relaxed);
+        if (next(pos) == head.load(std::memory_order_acquire)) return false;
+        buffer[pos] = std::move(data);
+        tail.store(next(pos), std::memory_order_release);
+        return true;
+    }
+    // Consumer side
+    bool dequeue(T &data) {
+        unsigned int pos = head.load(std::memory_order_relaxed);
+        if (pos == tail.load(std::memory_order_acquire)) return false;
+        data = std::move(buffer[pos]);
+        head.store(next(pos), std::memory_order_release);
         return true;
     }
-    void print() const { qNodes.print(); }
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,267 @@
+#ifndef ROARINGBITMAP_HPP
+#define ROARINGBITMAP_HPP
+
+#define ROARING_ARRAY_MAX 4096                     // Values an array container holds at most
+#define ROARING_BITMAP_WORDS (65536 / 64)          // 64-bit words of a bitmap container
+#define ROARING_BITMAP_BYTES (ROARING_BITMAP_WORDS * 8)
+#define ROARING_CONTAINER_HEADER (sizeof(uint16_t) + sizeof(uint32_t))
+
+#include <arpa/inet.h>
+#include <endian.h>
+#include <stdint.h>
+
+#include <cstring>
+#include <iostream>
+#include <utility>
+
+#include "SortedArray.hpp"
+
+// The values of a RoaringBitmap that share their upper 16 bits. Up to 4096 of
+// them are kept as a sorted array of their lower 16 bits, more than that as a
+// bitmap of all the 65536 possible ones, whichever is smaller.
+class roaringContainer {
+   private:
+    uint16_t key;  // Upper 16 bits of all the values
+    uint32_t cardinality;
+    uint32_t capacity;  // Of the array, which grows up to ROARING_ARRAY_MAX values
+    uint16_t *array;    // When cardinality <= ROARING_ARRAY_MAX
+    uint64_t *bitmap;   // Otherwise
+
+    // Position of the first array value which is NOT less than value
+    unsigned int lowerBound(uint16_t value) const {
+        unsigned int low = 0, high = cardinality;
+        while (low < high) {
+            unsigned int mid = low + (high - low) / 2;
+            if (array[mid] < value)
+                low = mid + 1;
+            else
+                high = mid;
+        }
+        return low;
+    }
+
+    void toBitmap() {
+        bitmap = new uint64_t[ROARING_BITMAP_WORDS];
+        memset(bitmap, 0, ROARING_BITMAP_BYTES);
+        for (unsigned int i = 0; i < cardinality; i++) bitmap[array[i] / 64] |= 1ULL << (array[i] % 64);
+        delete[] array;
+        array = NULL;
+        capacity = 0;
+    }
+
+    void grow() {
+        capacity = capacity ? capacity * 2 : 4;
+        if (capacity > ROARING_ARRAY_MAX) capacity = ROARING_ARRAY_MAX;
+        uint16_t *newArray = new uint16_t[capacity];
+        if (cardinality) memcpy(newArray, array, cardinality * sizeof(uint16_t));
+        delete[] array;
+        array = newArray;
+    }
+
+    void copy(const roaringContainer &c) {
+        key = c.key;
+        cardinality = c.cardinality;
+        capacity = 0;
+        array = NULL;
+        bitmap = NULL;
+        if (c.bitmap) {
+            bitmap = new uint64_t[ROARING_BITMAP_WORDS];
+            memcpy(bitmap, c.bitmap, ROARING_BITMAP_BYTES);
+        } else if (cardinality) {
+            capacity = cardinality;
+            array = new uint16_t[capacity];
+            memcpy(array, c.array, cardinality * sizeof(uint16_t));
+        }
+    }
+
+   public:
+    // The array is allocated on the first insertion, so that
+    // containers can be made just to search for their key
+    roaringContainer(uint16_t k = 0) : key(k), cardinality(0), capacity(0), array(NULL), bitmap(NULL) {}
+    ~roaringContainer() { delete[] array; delete[] bitmap; }
+    roaringContainer(const roaringContainer &c) { copy(c); }
+    roaringContainer(roaringContainer &&c)
+        : key(c.key), cardinality(c.cardinality), capacity(c.capacity), array(c.array), bitmap(c.bitmap) {
+        c.cardinality = c.capacity = 0;
+        c.array = NULL;
+        c.bitmap = NULL;
+    }
+    roaringContainer &operator=(const roaringContainer &c) {
+        if (this == &c) return *this;
+        delete[] array;
+        delete[] bitmap;
+        copy(c);
+        return *this;
+    }
+    roaringContainer &operator=(roaringContainer &&c) {
+        if (this == &c) return *this;
+        delete[] array;
+        delete[] bitmap;
+        key = c.key;
+        cardinality = c.cardinality;
+        capacity = c.capacity;
+        array = c.array;
+        bitmap = c.bitmap;
+        c.cardinality = c.capacity = 0;
+        c.array = NULL;
+        c.bitmap = NULL;
+        return *this;
+    }
+
+    uint16_t getKey() const { return key; }
+    uint32_t getCardinality() const { return cardinality; }
+    bool isBitmap() const { return bitmap != NULL; }
+
+    void insert(uint16_t value) {
+        if (bitmap) {
+            uint64_t mask = 1ULL << (value % 64);
+            if (!(bitmap[value / 64] & mask)) cardinality++;
+            bitmap[value / 64] |= mask;
+            return;
+        }
+        unsigned int pos = lowerBound(value);
+        if (pos < cardinality && array[pos] == value) return;
+        if (cardinality == ROARING_ARRAY_MAX) {
+            toBitmap();
+            insert(value);
+            return;
+        }
+        if (cardinality == capacity) grow();
+        memmove(array + pos + 1, array + pos, (cardinality - pos) * sizeof(uint16_t));
+        array[pos] = value;
+        cardinality++;
+    }
+
+    bool contains(uint16_t value) const {
+        if (bitmap) return bitmap[value / 64] & (1ULL << (value % 64));
+        unsigned int pos = lowerBound(value);
+        return pos < cardinality && array[pos] == value;
+    }
+
+    // Size of the serialized container: its key, cardinality and values,
+    // all of them in network byte order
+    unsigned int getBytes() const {
+        return ROARING_CONTAINER_HEADER + (bitmap ? ROARING_BITMAP_BYTES : cardinality * sizeof(uint16_t));
+    }
+    void serialize(char *out) const {
+        uint16_t netKey = htons(key);
+        uint32_t netCardinality = htonl(cardinality);
+        memcpy(out, &netKey, sizeof(uint16_t));
+        memcpy(out + sizeof(uint16_t), &netCardinality, sizeof(uint32_t));
+        out += ROARING_CONTAINER_HEADER;
+        if (bitmap) {
+            for (unsigned int w = 0; w < ROARING_BITMAP_WORDS; w++) {
+                uint64_t word = htobe64(bitmap[w]);
+                memcpy(out + w * sizeof(uint64_t), &word, sizeof(uint64_t));
+            }
+        } else {
+            for (unsigned int v = 0; v < cardinality; v++) {
+                uint16_t value = htons(array[v]);
+                memcpy(out + v * sizeof(uint16_t), &value, sizeof(uint16_t));
+            }
+        }
+    }
+    // Loads a serialized container from the start of size bytes.
+    // Returns the bytes it took, or 0 if they are malformed.
+    unsigned int load(const char *in, unsigned int size) {
+        uint32_t card = 0;
+        if (size < ROARING_CONTAINER_HEADER) return 0;
+        memcpy(&card, in + sizeof(uint16_t), sizeof(uint32_t));
+        card = ntohl(card);
+        unsigned int bytes = (card > ROARING_ARRAY_MAX) ? ROARING_BITMAP_BYTES : card * sizeof(uint16_t);
+        if (card > 65536 || size - ROARING_CONTAINER_HEADER < bytes) return 0;
+        delete[] array;
+        delete[] bitmap;
+        array = NULL;
+        bitmap = NULL;
+        memcpy(&key, in, sizeof(uint16_t));
+        key = ntohs(key);
+        cardinality = card;
+        capacity = 0;
+        if (card > ROARING_ARRAY_MAX) {
+            bitmap = new uint64_t[ROARING_BITMAP_WORDS];
+            memcpy(bitmap, in + ROARING_CONTAINER_HEADER, bytes);
+            for (unsigned int w = 0; w < ROARING_BITMAP_WORDS; w++) bitmap[w] = be64toh(bitmap[w]);
+        } else if (card) {
+            capacity = card;
+            array = new uint16_t[capacity];
+            memcpy(array, in + ROARING_CONTAINER_HEADER, bytes);
+            for (unsigned int v = 0; v < card; v++) array[v] = ntohs(array[v]);
+        }
+        return ROARING_CONTAINER_HEADER + bytes;
+    }
+
+    friend bool operator==(const roaringContainer &c1, const roaringContainer &c2) { return c1.key == c2.key; }
+    friend bool operator!=(const roaringContainer &c1, const roaringContainer &c2) { return c1.key != c2.key; }
+    friend bool operator<(const roaringContainer &c1, const roaringContainer &c2) { return c1.key < c2.key; }
+    friend std::ostream &operator<<(std::ostream &os, const roaringContainer &c) {
+        os << c.key << ":" << c.cardinality;
+        return os;
+    }
+};
+
+// Exact set of unsigned int values, such as citizen IDs (Chambi, Lemire et al.).
+// Values are split in containers by their upper 16 bits, each one stored in the
+// smaller of its two forms, so a dense range of IDs takes about 1 bit per ID.
+class RoaringBitmap {
+   private:
+    SortedArray<roaringContainer> containers;
+
+   public:
+    RoaringBitmap() {}
+    ~RoaringBitmap() {}
+
+    unsigned int getContainers() const { return containers.getSize(); }
+    unsigned int getCardinality() const {
+        unsigned int total = 0;
+        for (unsigned int c = 0; c < containers.getSize(); c++) total += containers.getNode(c)->getCardinality();
+        return total;
+    }
+    void flush() { containers.flush(); }
+
+    void insert(unsigned int value) {
+        roaringContainer *c = containers.search(roaringContainer(value >> 16));
+        if (!c) c = containers.insert(roaringContainer(value >> 16));
+        c->insert(value & 0xffff);
+    }
+
+    bool check(unsigned int value) const {
+        roaringContainer *c = containers.search(roaringContainer(value >> 16));
+        return c && c->contains(value & 0xffff);
+    }
+
+    // Size of the serialized bitmap: the number of containers, in network byte order, followed by them
+    unsigned int getBytes() const {
+        unsigned int bytes = sizeof(uint32_t);
+        for (unsigned int c = 0; c < containers.getSize(); c++) bytes += containers.getNode(c)->getBytes();
+        return bytes;
+    }
+    void serialize(char *out) const {
+        uint32_t count = containers.getSize(), netCount = htonl(count);
+        memcpy(out, &netCount, sizeof(uint32_t));
+        out += sizeof(uint32_t);
+        for (unsigned int c = 0; c < count; c++) {
+            containers.getNode(c)->serialize(out);
+            out += containers.getNode(c)->getBytes();
+        }
+    }
+    // Loads a serialized bitmap of given size. False if it's malformed.
+    bool load(const char *in, unsigned int size) {
+        uint32_t count = 0;
+        unsigned int pos = sizeof(uint32_t), bytes = 0;
+        flush();
+        if (size < sizeof(uint32_t)) return false;
+        memcpy(&count, in, sizeof(uint32_t));
+        count = ntohl(count);
+        roaringContainer c;
+        for (unsigned int n = 0; n < count; n++) {
+            if (!(bytes = c.load(in + pos, size - pos))) return false;
+            // c is loaded again from scratch, so its arrays are handed over
+            containers.insert(std::move(c));
+            pos += bytes;
+        }
+        return pos == size;
+    }
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,221 @@
+#ifndef SCALABLEBLOOMFILTER_HPP
+#define SCALABLEBLOOMFILTER_HPP
+
+#define SCALABLE_GROWTH 2        // Every layer holds this many times the keys of the previous one
+#define SCALABLE_TIGHTENING 0.5  // with this many times its false positive rate
+#define SCALABLE_LAYERS 4        // Initial capacity of the array of layers
+
+#include <cmath>
+#include <cstring>
+
+#include "BloomFilter.hpp"
+
+// Keys a filter of given bytes holds with the given false positive rate
+inline unsigned int scalableCapacity(unsigned int bytes, double fpr) {
+    double keys = (double)bytes * BITS_IN_BYTE * M_LN2 * M_LN2 / -log(fpr);
+    return (keys < 1) ? 1 : (unsigned int)keys;
+}
+
+// Optimal number of hash functions for the given false positive rate
+inline unsigned int scalableFunctions(double fpr) {
+    unsigned int k = (unsigned int)round(-log2(fpr));
+    return (k < 1) ? 1 : (k > BLOOM_MAX_FUNCTIONS) ? BLOOM_MAX_FUNCTIONS : k;
+}
+
+// Scalable bloom filter (Almeida et al.): an array of layers of filters of type F,
+// such as BloomFilter or CountingBloomFilter. Keys are inserted in the last
+// layer, until it holds as many keys as it was sized for, which is when about
+// half of its bits are set. Then a larger layer with a lower false positive
+// rate is added, so the rate of all layers together stays below the target,
+// however many keys are inserted, and the full layers never change again.
+// A key may be in any of the layers, so all of them are checked. Every layer
+// is allocated on its own, so a layer stays where it is as more are added.
+template <typename F>
+class ScalableBloomFilter {
+   private:
+    F **layers;
+    unsigned int numLayers, capacity;
+    unsigned int firstBytes;  // Size of the first layer
+    double firstFpr;          // Of the first layer
+    double fpr;               // Of the next layer that is added
+    unsigned int keys;        // Inserted in the last layer
+    unsigned int limit;       // Keys the last layer is sized for
+
+    // Appends a layer of the given geometry
+    F *appendLayer(unsigned int bytes, unsigned int functions) {
+        if (numLayers == capacity) {
+            capacity = capacity ? capacity * 2 : SCALABLE_LAYERS;
+            F **grown = new F *[capacity];
+            memcpy(grown, layers, numLayers * sizeof(F *));
+            delete[] layers;
+            layers = grown;
+        }
+        return layers[numLayers++] = new F(bytes, functions);
+    }
+
+    void addLayer() {
+        unsigned int bytes = firstBytes, functions = scalableFunctions(fpr);
+        if (!numLayers)
+            limit = scalableCapacity(bytes, fpr);
+        else
+            BloomFilter::optimalSize(limit *= SCALABLE_GROWTH, fpr, bytes, functions);
+        appendLayer(bytes, functions);
+        keys = 0;
+        fpr *= SCALABLE_TIGHTENING;
+    }
+
+    void copyLayers(const ScalableBloomFilter &filter) {
+        layers = new F *[capacity = filter.capacity];
+        for (numLayers = 0; numLayers < filter.numLayers; numLayers++)
+            layers[numLayers] = new F(*filter.layers[numLayers]);
+    }
+
+   public:
+    // The layers are only added as keys are inserted, or one by one with
+    // setLayer, when they are copies of the layers of another filter.
+    // Given rate is that of all the layers together, which is bounded by the
+    // sum of the rates of the layers: firstFpr / (1 - SCALABLE_TIGHTENING)
+    ScalableBloomFilter(unsigned int bytes = BLOOM_MIN_BYTES, double targetFpr = 0.01)
+        : layers(new F *[SCALABLE_LAYERS]), numLayers(0), capacity(SCALABLE_LAYERS), firstBytes(bytes),
+          firstFpr(targetFpr * (1 - SCALABLE_TIGHTENING)), fpr(firstFpr), keys(0), limit(0) {}
+    ~ScalableBloomFilter() {
+        truncate(0);
+        delete[] layers;
+    }
+
+    ScalableBloomFilter(const ScalableBloomFilter &filter)
+        : firstBytes(filter.firstBytes), firstFpr(filter.firstFpr), fpr(filter.fpr),
+          keys(filter.keys), limit(filter.limit) {
+        copyLayers(filter);
+    }
+
+    ScalableBloomFilter &operator=(const ScalableBloomFilter &filter) {
+        if (this == &filter) return *this;
+        truncate(0);
+        delete[] layers;
+        copyLayers(filter);
+        firstBytes = filter.firstBytes;
+        firstFpr = filter.firstFpr;
+        fpr = filter.fpr;
+        keys = filter.keys;
+        limit = filter.limit;
+        return *this;
+    }
+
+    // The moved-from filter is left without layers, and takes no more
+    ScalableBloomFilter(ScalableBloomFilter &&filter)
+        : layers(filter.layers), numLayers(filter.numLayers), capacity(filter.capacity),
+          firstBytes(filter.firstBytes), firstFpr(filter.firstFpr), fpr(filter.fpr),
+          keys(filter.keys), limit(filter.limit) {
+        filter.layers = NULL;
+        filter.numLayers = filter.capacity = 0;
+    }
+
+    ScalableBloomFilter &operator=(ScalableBloomFilter &&filter) {
+        if (this == &filter) return *this;
+        truncate(0);
+        delete[] layers;
+        layers = filter.layers;
+        numLayers = filter.numLayers;
+        capacity = filter.capacity;
+        firstBytes = filter.firstBytes;
+        firstFpr = filter.firstFpr;
+        fpr = filter.fpr;
+        keys = filter.keys;
+        limit = filter.limit;
+        filter.layers = NULL;
+        filter.numLayers = filter.capacity = 0;
+        return *this;
+    }
+
+    // Adds the first layer ahead of any key, for a filter that
+    // must exist, and be sent, while it's still empty
+    void addFirstLayer() {
+        if (!numLayers) addLayer();
+    }
+
+    // Drops all the layers and sizes the next first layer for the given number
+    // of keys, which are to be inserted again, with optimalSize
+    void resize(unsigned int expected) {
+        unsigned int functions = 0;
+        truncate(0);
+        fpr = firstFpr;
+        BloomFilter::optimalSize(expected, fpr, firstBytes, functions);
+    }
+
+    unsigned int getLayers() const { return numLayers; }
+    F *getLayer(unsigned int layer) { return (layer < numLayers) ? layers[layer] : NULL; }
+
+    // Returns the given layer, reset to the given geometry if it doesn't match, or
+    // appended if it's the next one. NULL if the layers before it are missing.
+    F *setLayer(unsigned int layer, unsigned int bytes, unsigned int functions) {
+        if (layer > numLayers) return NULL;
+        if (layer == numLayers) return appendLayer(bytes, functions);
+        F *f = layers[layer];
+        if (f->getSize() != bytes * BITS_IN_BYTE || f->getFunctionsNumber() != functions)
+            *f = F(bytes, functions);
+        return f;
+    }
+    // Drops the layers after the first count ones
+    void truncate(unsigned int count) {
+        while (numLayers > count) delete layers[--numLayers];
+    }
+
+    template <typename K>
+    void insert(const K &input) {
+        if (!numLayers || keys >= limit) addLayer();
+        layers[numLayers - 1]->insert(input);
+        keys++;
+    }
+
+    // Removes a key of a layer of counters. A key that more layers may contain
+    // is left in place, since it's only known to be in one of them, and a
+    // false positive is better than decrementing the counters of other keys.
+    // A key removed from the last layer makes room for another one in it.
+    template <typename K>
+    void remove(const K &input) {
+        int found = -1;
+        for (unsigned int layer = 0; layer < numLayers; layer++) {
+            if (!layers[layer]->check(input)) continue;
+            if (found >= 0) return;
+            found = layer;
+        }
+        if (found < 0) return;
+        layers[found]->remove(input);
+        if ((unsigned int)found == numLayers - 1 && keys) keys--;
+    }
+
+    template <typename K>
+    bool check(const K &input) {
+        for (unsigned int layer = 0; layer < numLayers; layer++)
+            if (layers[layer]->check(input)) return true;
+        return false;
+    }
+
+    // Same as check for n keys at once, each layer checking a batch of them
+    // with its checkMany, so that the probes of the batch are prefetched
+    template <typename K>
+    void checkMany(const K *input, unsigned int n, bool *out) {
+        bool hit[BLOOM_BATCH];
+        for (unsigned int first = 0; first < n; first += BLOOM_BATCH) {
+            unsigned int batch = (n - first < BLOOM_BATCH) ? n - first : BLOOM_BATCH;
+            for (unsigned int key = 0; key < batch; key++) out[first + key] = false;
+            for (unsigned int layer = 0; layer < numLayers; layer++) {
+                layers[layer]->checkMany(input + first, batch, hit);
+                for (unsigned int key = 0; key < batch; key++) out[first + key] = out[first + key] || hit[key];
+            }
+        }
+    }
+
+    // The newest layer that may contain the key, or -1 if none does.
+    // It's mostly the layer the key was inserted in, as the newer
+    // layers have fewer false positives than the older ones.
+    template <typename K>
+    int newestLayer(const K &input) {
+        for (int layer = numLayers - 1; layer >= 0; layer--)
+            if (layers[layer]->check(input)) return layer;
+        return -1;
+    }
+};
+
+#endif
\ No newline at end of file
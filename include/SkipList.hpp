@@ -3,6 +3,9 @@
 
 #include <cstdlib>
 #include <ctime>
+#include <utility>
+
+#include "List.hpp"
 
 #define DEFAULT_LEVELS 5
 #define PROBABILITY 0.5
@@ -16,6 +19,11 @@ class SkipList {
     struct skipNode {
         T data;
         skipNode **nextAtLevel;
+        // Number of level-0 steps each forward pointer skips.
+        // For the last node of a level it's the number of nodes left after it.
+        int *spanAtLevel;
+        template <typename U>
+        skipNode(U &&d) : data(std::forward<U>(d)), nextAtLevel(NULL), spanAtLevel(NULL) {}
     };
     int size;
     skipNode *head, *const tail;
@@ -32,35 +40,75 @@ class SkipList {
         return level;
     }
 
-    skipNode *createNode(T data, int lvls = DEFAULT_LEVELS) {
-        skipNode *node = new skipNode;
-        node->data = data;
+    template <typename U>
+    skipNode *createNode(U &&data, int lvls = DEFAULT_LEVELS) {
+        skipNode *node = new skipNode(std::forward<U>(data));
         node->nextAtLevel = new skipNode *[lvls];
-        for (int i = 0; i < lvls; i++)
+        node->spanAtLevel = new int[lvls];
+        for (int i = 0; i < lvls; i++) {
             node->nextAtLevel[i] = tail;
+            node->spanAtLevel[i] = 0;
+        }
         return node;
     }
 
     void deleteNode(skipNode *node) {
         if (!node) return;
         delete[] node->nextAtLevel;
+        delete[] node->spanAtLevel;
         delete node;
     }
 
-    // Copies the given list recursively so that
+    // Returns the last node which is less than data (or the head)
+    // while counting the position it is at
+    skipNode *findPrevious(const T &data, int &rank) const {
+        skipNode *temp = head;
+        rank = 0;
+        for (int i = maxLevel - 1; i >= 0; i--)
+            while (temp->nextAtLevel[i] && data > temp->nextAtLevel[i]->data) {
+                rank += temp->spanAtLevel[i];
+                temp = temp->nextAtLevel[i];
+            }
+        return temp;
+    }
+
+    // Returns the node at the given 1-based position using the spans
+    skipNode *findByRank(int rank) const {
+        skipNode *temp = head;
+        int traversed = 0;
+        for (int i = maxLevel - 1; i >= 0; i--)
+            while (temp->nextAtLevel[i] && traversed + temp->spanAtLevel[i] <= rank) {
+                traversed += temp->spanAtLevel[i];
+                temp = temp->nextAtLevel[i];
+            }
+        return (traversed == rank) ? temp : NULL;
+    }
+
+    // Copies the given list node by node so that
     // the final form is identical with the original
-    void recCopy(skipNode *node) {
-        if (node) {
-            recCopy(node->nextAtLevel[0]);
+    void copyNodes(skipNode *node) {
+        for (; node; node = node->nextAtLevel[0])
             insert(node->data);
-        }
     }
 
     // Deletes all nodes except the arbitrary head node
     void flush() {
-        while (!empty()) remove(getFirst());
+        skipNode *temp = head->nextAtLevel[0], *next = NULL;
+        for (; temp; temp = next) {
+            next = temp->nextAtLevel[0];
+            deleteNode(temp);
+        }
+        for (int i = 0; i < maxLevel; i++) {
+            head->nextAtLevel[i] = tail;
+            head->spanAtLevel[i] = 0;
+        }
+        size = 0;
     }
 
+    // Inserts data (copied or moved) in its sorted position
+    template <typename U>
+    void insertData(U &&data);
+
    public:
     SkipList(int lvls = DEFAULT_LEVELS, double probability = PROBABILITY)
         : maxLevel(lvls), size(0), tail(NULL), p(PROBABILITY) {
@@ -72,79 +120,124 @@ class SkipList {
     }
     ~SkipList() {
         flush();
-        delete[] head->nextAtLevel;
-        delete head;
-        delete tail;
+        deleteNode(head);
     }
     SkipList(const SkipList &l);
+    SkipList(SkipList &&l);
 
     SkipList &operator=(const SkipList &l);
+    SkipList &operator=(SkipList &&l);
 
     int getMaxLevel() const { return maxLevel; }
     int getSize() const { return size; }
     T &getFirst() { return head->nextAtLevel[0]->data; }
 
-    void insert(const T data);
-    void remove(const T data);
+    void insert(const T &data) { insertData(data); }
+    void insert(T &&data) { insertData(std::move(data)); }
+    // Constructs the element from the given arguments and moves it in place
+    template <typename... Args>
+    void emplace(Args &&...args) { insertData(T(std::forward<Args>(args)...)); }
+    void remove(const T &data);
 
     bool empty() const { return !size; }
     void print() const;
+    // Returns the element at the given 0-based position in O(log n)
     T *getNode(int pos);
-    T *search(const T data) const;
+    T *search(const T &data) const;
+    // Returns the number of elements less than data, which is
+    // also the position that data has (or would have) in the list
+    int rank(const T &data) const;
+    // Appends all elements within [low, high] to result in ascending order
+    // and returns how many they were
+    int range(const T &low, const T &high, List<T> &result) const;
+    // Appends up to count elements starting from position pos to result
+    // and returns how many they were
+    int page(int pos, int count, List<T> &result) const;
 };
 
 template <typename T>
 SkipList<T>::SkipList(const SkipList &l)
-    : maxLevel(DEFAULT_LEVELS), tail(NULL), p(PROBABILITY) {
-    if (this == &l) return;
-    flush();
-    recCopy(l.head->nextAtLevel[0]);
+    : maxLevel(l.maxLevel), size(0), tail(NULL), p(l.p) {
+    this->head = createNode(-1, maxLevel);
+    copyNodes(l.head->nextAtLevel[0]);
+}
+
+// The moved-from list is left empty but usable, with a head of its own
+template <typename T>
+SkipList<T>::SkipList(SkipList &&l)
+    : maxLevel(l.maxLevel), size(l.size), head(l.head), tail(NULL), p(l.p) {
+    l.head = l.createNode(-1, l.maxLevel);
+    l.size = 0;
 }
 
 template <typename T>
 SkipList<T> &SkipList<T>::operator=(const SkipList &l) {
     if (this == &l) return *this;
     flush();
-    recCopy(l.head->nextAtLevel[0]);
+    copyNodes(l.head->nextAtLevel[0]);
     return *this;
 }
 
 template <typename T>
-void SkipList<T>::insert(const T data) {
+SkipList<T> &SkipList<T>::operator=(SkipList &&l) {
+    if (this == &l) return *this;
+    // Swap the contents so that l releases the old nodes of this list
+    skipNode *tempHead = head;
+    int tempLevel = maxLevel, tempSize = size;
+    head = l.head; maxLevel = l.maxLevel; size = l.size;
+    l.head = tempHead; l.maxLevel = tempLevel; l.size = tempSize;
+    l.flush();
+    return *this;
+}
+
+template <typename T>
+template <typename U>
+void SkipList<T>::insertData(U &&data) {
     // Array of pointers on every level which will
     // be affected by the insertion of the new node
     skipNode *previousAtLevel[maxLevel];
+    // Position of each of these nodes in the list
+    int rankAtLevel[maxLevel];
     // Initialize them all pointing to the tail (NULL)
     for (int i = 0; i < maxLevel; i++)
         previousAtLevel[i] = tail;
 
     skipNode *temp = head;
     for (int i = maxLevel - 1; i >= 0; i--) {
-        while (temp->nextAtLevel[i] && data > temp->nextAtLevel[i]->data)
+        rankAtLevel[i] = (i == maxLevel - 1) ? 0 : rankAtLevel[i + 1];
+        while (temp->nextAtLevel[i] && data > temp->nextAtLevel[i]->data) {
+            rankAtLevel[i] += temp->spanAtLevel[i];
             temp = temp->nextAtLevel[i];
+        }
         // Save the last node on the current level before we have to move lower
         previousAtLevel[i] = temp;
     }
 
     // Don't insert duplicates
-    if (temp->data != data) {
-        // Create the new node with random number of maxLevel up to max allowed
-        int randomLevels = generateLevels();
-        skipNode *node = createNode(data, randomLevels);
+    if (temp->nextAtLevel[0] && temp->nextAtLevel[0]->data == data) return;
 
-        // Traverse from the top levels to the bottom and fix pointers affected
-        for (int i = randomLevels - 1; i >= 0; i--) {
-            // Link the new node right after the last node we traversed in each level
-            node->nextAtLevel[i] = previousAtLevel[i]->nextAtLevel[i];
-            // Rearrange the pointers before new node at each level
-            previousAtLevel[i]->nextAtLevel[i] = node;
-        }
-        this->size++;
+    // Create the new node with random number of maxLevel up to max allowed
+    int randomLevels = generateLevels();
+    skipNode *node = createNode(std::forward<U>(data), randomLevels);
+
+    // Traverse from the top levels to the bottom and fix pointers affected
+    for (int i = randomLevels - 1; i >= 0; i--) {
+        // Link the new node right after the last node we traversed in each level
+        node->nextAtLevel[i] = previousAtLevel[i]->nextAtLevel[i];
+        // Rearrange the pointers before new node at each level
+        previousAtLevel[i]->nextAtLevel[i] = node;
+        // Split the span of the previous node at the new node's position
+        node->spanAtLevel[i] = previousAtLevel[i]->spanAtLevel[i] - (rankAtLevel[0] - rankAtLevel[i]);
+        previousAtLevel[i]->spanAtLevel[i] = (rankAtLevel[0] - rankAtLevel[i]) + 1;
     }
+    // The levels above the new node just skip one more node now
+    for (int i = randomLevels; i < maxLevel; i++)
+        previousAtLevel[i]->spanAtLevel[i]++;
+    this->size++;
 }
 
 template <typename T>
-void SkipList<T>::remove(const T data) {
+void SkipList<T>::remove(const T &data) {
     // Array of pointers on every level which will
     // be affected by the removal of the node
     skipNode *previousAtLevel[maxLevel];
@@ -166,12 +259,15 @@ void SkipList<T>::remove(const T data) {
     temp = temp->nextAtLevel[0];
 
     // Delete if found
-    if (temp->data == data) {
+    if (temp && temp->data == data) {
         // Traverse from the top levels to the bottom and fix pointers affected
-        for (int i = maxLevel - 1; i >= 0; i--)
+        for (int i = maxLevel - 1; i >= 0; i--) {
             // Only rearrange the nodes that we previous of the removed node at some level
-            if (previousAtLevel[i]->nextAtLevel[i] == temp)
+            if (previousAtLevel[i]->nextAtLevel[i] == temp) {
+                previousAtLevel[i]->spanAtLevel[i] += temp->spanAtLevel[i] - 1;
                 previousAtLevel[i]->nextAtLevel[i] = temp->nextAtLevel[i];
+            } else previousAtLevel[i]->spanAtLevel[i]--;
+        }
         deleteNode(temp);
         this->size--;
     }
@@ -193,16 +289,14 @@ void SkipList<T>::print() const {
 
 template <typename T>
 T *SkipList<T>::getNode(int pos) {
-    if (pos > size) return NULL;
-    skipNode *temp = head->nextAtLevel[0];
-    for (; pos > 0; pos--)
-        temp = temp->nextAtLevel[0];
-    T *ptr = &temp->data;
-    return ptr;
+    if (pos < 0 || pos >= size) return NULL;
+    // Positions are 0-based but the head node is at rank 0
+    skipNode *temp = findByRank(pos + 1);
+    return temp ? &temp->data : NULL;
 }
 
 template <typename T>
-T *SkipList<T>::search(const T data) const {
+T *SkipList<T>::search(const T &data) const {
     if (empty()) return NULL;
     skipNode *temp = head;
     for (int i = maxLevel - 1; i >= 0; i--)
@@ -216,4 +310,31 @@ T *SkipList<T>::search(const T data) const {
     return NULL;
 }
 
+template <typename T>
+int SkipList<T>::rank(const T &data) const {
+    int rank = 0;
+    findPrevious(data, rank);
+    return rank;
+}
+
+template <typename T>
+int SkipList<T>::range(const T &low, const T &high, List<T> &result) const {
+    int rank = 0, count = 0;
+    // Start right after the last node which is less than low
+    skipNode *temp = findPrevious(low, rank)->nextAtLevel[0];
+    for (; temp && temp->data <= high; temp = temp->nextAtLevel[0], count++)
+        result.insertLast(temp->data);
+    return count;
+}
+
+template <typename T>
+int SkipList<T>::page(int pos, int count, List<T> &result) const {
+    if (pos < 0 || pos >= size || count <= 0) return 0;
+    int added = 0;
+    skipNode *temp = findByRank(pos + 1);
+    for (; temp && added < count; temp = temp->nextAtLevel[0], added++)
+        result.insertLast(temp->data);
+    return added;
+}
+
 #endif
\ No newline at end of file
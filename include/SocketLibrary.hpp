@@ -6,6 +6,7 @@
 #include <netinet/in.h>
 #include <sys/socket.h>
 #include <sys/types.h>
+#include <sys/uio.h>
 
 #include <iostream>
 
@@ -16,9 +17,25 @@
 int createSocket();
 void bindSocket(int &sock, const sockaddr *sockPtr, socklen_t len);
 void listenConnections(int sockfd, int maxConn);
+// Returns -1 once the socket has stopped listening
 int acceptConnection(int sockfd, sockaddr *addr, socklen_t *len);
+// Wakes up every thread that waits to accept a connection on the socket
+void stopListening(int sockfd);
 void closeSocket(int sock);
-void writeToSocket(int sockfd, void *message, size_t bufferSize);
-void readFromSocket(int sockfd, void *message, size_t bufferSize);
+// Closes the socket with a reset, so that its port isn't held in TIME_WAIT
+void abortSocket(int sock);
+// True if the socket is connected to itself. That happens to a connection to a port that
+// no-one listens to yet, if it's in the range that the kernel picks local ports from.
+bool connectedToItself(int sockfd);
+// Makes the calls on the socket return instead of waiting, or wait again
+void setBlocking(int sock, bool blocking);
+// These retry until every byte is sent or received, however many calls it takes.
+// False if the connection was closed or broken first, with errno telling why.
+bool writeToSocket(int sockfd, const void *message, size_t bufferSize);
+bool writeVectorToSocket(int sockfd, iovec *parts, int count);
+bool readFromSocket(int sockfd, void *message, size_t bufferSize);
+// Receives as many bytes as are available (at least one) into the parts, and
+// returns their number, or 0 if the connection was closed or broken
+size_t readSomeFromSocket(int sockfd, iovec *parts, int count);
 
 #endif
\ No newline at end of file
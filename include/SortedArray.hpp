@@ -0,0 +1,179 @@
+#ifndef SORTEDARRAY_HPP
+#define SORTEDARRAY_HPP
+
+#include <cstring>
+#include <iostream>
+#include <utility>
+
+#define SORTED_ARRAY_CAPACITY 8
+
+// An ordered collection of unique elements, kept sorted by operator<.
+// Elements are allocated once and only their pointers are moved around,
+// so pointers returned by search/insert stay valid until the element is removed.
+// Lookups are binary searches and positional access is O(1).
+template <typename T>
+class SortedArray {
+   private:
+    unsigned int size;
+    unsigned int capacity;
+    T **items;
+
+    // Returns the position of the first element which is NOT less than data
+    unsigned int lowerBound(const T &data) const;
+    void grow();
+    // Returns the element equal to data if one is stored. Otherwise it
+    // makes room for data at pos, its sorted position, and returns NULL.
+    T *openSlot(const T &data, unsigned int &pos);
+
+   public:
+    SortedArray(unsigned int cap = SORTED_ARRAY_CAPACITY)
+        : size(0), capacity(cap ? cap : 1) { items = new T *[capacity]; }
+    SortedArray(const SortedArray &a);
+    SortedArray(SortedArray &&a);
+    ~SortedArray() { flush(); delete[] items; }
+    SortedArray &operator=(const SortedArray &a);
+    SortedArray &operator=(SortedArray &&a);
+
+    unsigned int getSize() const { return size; }
+    T &getFirst() { return *items[0]; }
+    T &getLast() { return *items[size - 1]; }
+
+    // Inserts a copy of data in its sorted position and returns the stored element.
+    // If an equal element is already stored, that one is returned instead.
+    T *insert(const T &data);
+    // Same, moving data into the new element, which is left as is if it's not inserted
+    T *insert(T &&data);
+    void remove(const T &data);
+
+    bool empty() const { return !size; }
+    void flush();
+
+    void print() const;
+    T *getNode(unsigned int pos) const { return (pos < size) ? items[pos] : NULL; }
+    T *search(const T &data) const;
+};
+
+template <typename T>
+SortedArray<T>::SortedArray(const SortedArray<T> &a) : size(0), capacity(a.capacity) {
+    items = new T *[capacity];
+    for (unsigned int pos = 0; pos < a.size; pos++) items[pos] = new T(*a.items[pos]);
+    size = a.size;
+}
+
+template <typename T>
+SortedArray<T>::SortedArray(SortedArray<T> &&a) : size(a.size), capacity(a.capacity), items(a.items) {
+    // The moved-from array is left empty, and allocates again once it's used
+    a.size = a.capacity = 0;
+    a.items = NULL;
+}
+
+template <typename T>
+SortedArray<T> &SortedArray<T>::operator=(const SortedArray<T> &a) {
+    if (this == &a) return *this;
+    flush();
+    delete[] items;
+    capacity = a.capacity;
+    items = new T *[capacity];
+    for (unsigned int pos = 0; pos < a.size; pos++) items[pos] = new T(*a.items[pos]);
+    size = a.size;
+    return *this;
+}
+
+template <typename T>
+SortedArray<T> &SortedArray<T>::operator=(SortedArray<T> &&a) {
+    if (this == &a) return *this;
+    flush();
+    delete[] items;
+    size = a.size;
+    capacity = a.capacity;
+    items = a.items;
+    a.size = a.capacity = 0;
+    a.items = NULL;
+    return *this;
+}
+
+template <typename T>
+unsigned int SortedArray<T>::lowerBound(const T &data) const {
+    unsigned int low = 0, high = size;
+    while (low < high) {
+        unsigned int mid = low + (high - low) / 2;
+        if (*items[mid] < data)
+            low = mid + 1;
+        else
+            high = mid;
+    }
+    return low;
+}
+
+template <typename T>
+void SortedArray<T>::grow() {
+    unsigned int newCapacity = capacity ? capacity * 2 : SORTED_ARRAY_CAPACITY;
+    T **newItems = new T *[newCapacity];
+    if (size) memcpy(newItems, items, size * sizeof(T *));
+    delete[] items;
+    items = newItems;
+    capacity = newCapacity;
+}
+
+template <typename T>
+T *SortedArray<T>::openSlot(const T &data, unsigned int &pos) {
+    pos = lowerBound(data);
+    if (pos < size && *items[pos] == data) return items[pos];
+    if (size == capacity) grow();
+    // Shift the pointers after pos one place to the right
+    memmove(items + pos + 1, items + pos, (size - pos) * sizeof(T *));
+    return NULL;
+}
+
+template <typename T>
+T *SortedArray<T>::insert(const T &data) {
+    unsigned int pos = 0;
+    T *found = openSlot(data, pos);
+    if (found) return found;
+    items[pos] = new T(data);
+    size++;
+    return items[pos];
+}
+
+template <typename T>
+T *SortedArray<T>::insert(T &&data) {
+    unsigned int pos = 0;
+    T *found = openSlot(data, pos);
+    if (found) return found;
+    items[pos] = new T(std::move(data));
+    size++;
+    return items[pos];
+}
+
+template <typename T>
+void SortedArray<T>::remove(const T &data) {
+    unsigned int pos = lowerBound(data);
+    if (pos >= size || *items[pos] != data) return;
+    delete items[pos];
+    memmove(items + pos, items + pos + 1, (size - pos - 1) * sizeof(T *));
+    size--;
+}
+
+template <typename T>
+void SortedArray<T>::flush() {
+    for (unsigned int pos = 0; pos < size; pos++)
+        delete items[pos];
+    size = 0;
+}
+
+template <typename T>
+void SortedArray<T>::print() const {
+    if (empty()) return;
+    for (unsigned int pos = 0; pos < size - 1; pos++)
+        std::cout << *items[pos] << " ==> ";
+    std::cout << *items[size - 1] << std::endl;
+}
+
+template <typename T>
+T *SortedArray<T>::search(const T &data) const {
+    unsigned int pos = lowerBound(data);
+    if (pos < size && *items[pos] == data) return items[pos];
+    return NULL;
+}
+
+#endif
\ No newline at end of file
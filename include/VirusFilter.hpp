@@ -0,0 +1,16 @@
+#ifndef VIRUSFILTER_HPP
+#define VIRUSFILTER_HPP
+
+#include "BlockedBloomFilter.hpp"
+#include "BloomFilter.hpp"
+
+// The filter kept for every virus by both monitorServer and travelMonitorClient.
+// Filters travel as raw arrays, so both programs must be built with the same type.
+// Build with "make DEFS=-DBLOCKED_BLOOM" to use the cache-line-blocked variant.
+#ifdef BLOCKED_BLOOM
+typedef BlockedBloomFilter VirusFilter;
+#else
+typedef BloomFilter VirusFilter;
+#endif
+
+#endif
\ No newline at end of file
@@ -0,0 +1,179 @@
+#ifndef XORFILTER_HPP
+#define XORFILTER_HPP
+
+#define XOR_HASHES 3
+#define XOR_MAX_ATTEMPTS 64
+#define XOR_HEADER_SIZE (sizeof(uint64_t) + sizeof(uint32_t))
+
+#include <arpa/inet.h>
+#include <endian.h>
+#include <stdint.h>
+
+#include <cstring>
+#include <iostream>
+
+#include "hashFunctions.hpp"
+
+// Static xor filter with 8-bit fingerprints (Graf & Lemire), built once from a
+// set of distinct unsigned int keys, such as citizen IDs. It takes about 9.84
+// bits per key for a false positive rate of 1/256, and every lookup reads
+// exactly three bytes, one from each third of the fingerprints array.
+class XorFilter {
+   private:
+    uint64_t seed;
+    uint32_t blockLength;  // Fingerprints in each of the three blocks
+    unsigned char *fingerprints;
+
+    uint64_t hashKey(unsigned int key) const { return fmix64((uint64_t)key + seed); }
+    unsigned char fingerprint(uint64_t hash) const { return (unsigned char)(hash ^ (hash >> 32)); }
+    // Position of the i-th probe of hash, in the i-th block
+    uint32_t probe(unsigned int i, uint64_t hash) const {
+        uint32_t r = (uint32_t)(i ? rotl64(hash, 21 * i) : hash);
+        return (uint32_t)(((uint64_t)r * blockLength) >> 32) + i * blockLength;
+    }
+
+   public:
+    XorFilter() : seed(0), blockLength(0), fingerprints(NULL) {}
+    ~XorFilter() { delete[] fingerprints; }
+
+    XorFilter(const XorFilter &filter) : seed(filter.seed), blockLength(filter.blockLength) {
+        fingerprints = new unsigned char[XOR_HASHES * blockLength];
+        memcpy(fingerprints, filter.fingerprints, XOR_HASHES * blockLength);
+    }
+
+    XorFilter &operator=(const XorFilter &filter) {
+        if (this == &filter) return *this;
+        delete[] fingerprints;
+        seed = filter.seed;
+        blockLength = filter.blockLength;
+        fingerprints = new unsigned char[XOR_HASHES * blockLength];
+        memcpy(fingerprints, filter.fingerprints, XOR_HASHES * blockLength);
+        return *this;
+    }
+
+    // The moved-from filter is left empty, without fingerprints
+    XorFilter(XorFilter &&filter)
+        : seed(filter.seed), blockLength(filter.blockLength), fingerprints(filter.fingerprints) {
+        filter.blockLength = 0;
+        filter.fingerprints = NULL;
+    }
+
+    XorFilter &operator=(XorFilter &&filter) {
+        if (this == &filter) return *this;
+        delete[] fingerprints;
+        seed = filter.seed;
+        blockLength = filter.blockLength;
+        fingerprints = filter.fingerprints;
+        filter.blockLength = 0;
+        filter.fingerprints = NULL;
+        return *this;
+    }
+
+    // Builds the filter from n distinct keys. False if it failed for every
+    // seed it tried, which practically only happens for repeated keys.
+    bool build(const unsigned int *keys, unsigned int n);
+
+    bool check(unsigned int key) const {
+        if (!blockLength) return false;
+        uint64_t hash = hashKey(key);
+        unsigned char f = fingerprint(hash);
+        for (unsigned int i = 0; i < XOR_HASHES; i++) f ^= fingerprints[probe(i, hash)];
+        return !f;
+    }
+
+    // Size of the serialized filter: the seed and the block length, in network
+    // byte order, and the fingerprints
+    unsigned int getBytes() const { return XOR_HEADER_SIZE + XOR_HASHES * blockLength; }
+    void serialize(char *out) const {
+        uint64_t netSeed = htobe64(seed);
+        uint32_t netLength = htonl(blockLength);
+        memcpy(out, &netSeed, sizeof(uint64_t));
+        memcpy(out + sizeof(uint64_t), &netLength, sizeof(uint32_t));
+        memcpy(out + XOR_HEADER_SIZE, fingerprints, XOR_HASHES * blockLength);
+    }
+    // Loads a serialized filter of given size. False if the size doesn't match.
+    bool load(const char *in, unsigned int size) {
+        uint32_t length = 0;
+        if (size < XOR_HEADER_SIZE) return false;
+        memcpy(&length, in + sizeof(uint64_t), sizeof(uint32_t));
+        length = ntohl(length);
+        // In 64 bits, so that no length wraps around to the size
+        if ((uint64_t)size != XOR_HEADER_SIZE + (uint64_t)XOR_HASHES * length) return false;
+        delete[] fingerprints;
+        memcpy(&seed, in, sizeof(uint64_t));
+        seed = be64toh(seed);
+        blockLength = length;
+        fingerprints = new unsigned char[XOR_HASHES * blockLength];
+        memcpy(fingerprints, in + XOR_HEADER_SIZE, XOR_HASHES * blockLength);
+        return true;
+    }
+};
+
+inline bool XorFilter::build(const unsigned int *keys, unsigned int n) {
+    uint32_t length = (32 + n + n / 4 + n / 50) / XOR_HASHES + 1;  // 1.23n + 32 slots in total
+    uint32_t capacity = XOR_HASHES * length;
+    // Every slot keeps the xor of the hashes of the keys mapped to it and their count
+    uint64_t *xorMask = new uint64_t[capacity];
+    uint32_t *count = new uint32_t[capacity];
+    uint32_t *queue = new uint32_t[capacity];
+    // Keys in the order they were peeled, with the slot that was left to each
+    uint64_t *stackHash = new uint64_t[n ? n : 1];
+    uint32_t *stackSlot = new uint32_t[n ? n : 1];
+    unsigned int peeled = 0;
+    bool built = false;
+    blockLength = length;
+
+    for (unsigned int attempt = 0; attempt < XOR_MAX_ATTEMPTS; attempt++) {
+        seed = fmix64(0x9e3779b97f4a7c15ULL * (attempt + 1));
+        memset(xorMask, 0, capacity * sizeof(uint64_t));
+        memset(count, 0, capacity * sizeof(uint32_t));
+        for (unsigned int k = 0; k < n; k++) {
+            uint64_t hash = hashKey(keys[k]);
+            for (unsigned int i = 0; i < XOR_HASHES; i++) {
+                uint32_t slot = probe(i, hash);
+                xorMask[slot] ^= hash;
+                count[slot]++;
+            }
+        }
+        // Peel the slots with a single key, until none is left
+        unsigned int queued = 0;
+        for (uint32_t slot = 0; slot < capacity; slot++)
+            if (count[slot] == 1) queue[queued++] = slot;
+        peeled = 0;
+        while (queued) {
+            uint32_t slot = queue[--queued];
+            if (count[slot] != 1) continue;
+            uint64_t hash = xorMask[slot];
+            stackHash[peeled] = hash;
+            stackSlot[peeled++] = slot;
+            for (unsigned int i = 0; i < XOR_HASHES; i++) {
+                uint32_t other = probe(i, hash);
+                xorMask[other] ^= hash;
+                if (--count[other] == 1) queue[queued++] = other;
+            }
+        }
+        if ((built = (peeled == n))) break;
+    }
+
+    delete[] fingerprints;
+    fingerprints = new unsigned char[capacity];
+    memset(fingerprints, 0, capacity);
+    if (built) {
+        // Assign the fingerprints in reverse peeling order, so that the slot
+        // of every key is set last, to make the xor of its three probes match
+        while (peeled--) {
+            uint64_t hash = stackHash[peeled];
+            unsigned char f = fingerprint(hash);
+            for (unsigned int i = 0; i < XOR_HASHES; i++) f ^= fingerprints[probe(i, hash)];
+            fingerprints[stackSlot[peeled]] ^= f;
+        }
+    }
+    delete[] xorMask;
+    delete[] count;
+    delete[] queue;
+    delete[] stackHash;
+    delete[] stackSlot;
+    return built;
+}
+
+#endif
\ No newline at end of file
@@ -115,6 +115,7 @@ int getOptions (std::string input) {
     if (!input.compare("/travelStats")) return travelStats;
     if (!input.compare("/addVaccinationRecords")) return addRecords;
     if (!input.compare("/searchVaccinationStatus")) return searchStatus;
+    if (!input.compare("/bloomStats")) return bloomStats;
     if (!input.compare("/help")) return help;
     return -1;
 }
@@ -126,6 +127,7 @@ void printOptions() {
     "/travelStats virusName date1 date2 [country]\n" \
     "/addVaccinationRecords country\n" \
     "/searchVaccinationStatus citizenID\n" \
+    "/bloomStats [virusName]\n" \
     "/exit\n" \
     "=============================================================\n";
 }
@@ -0,0 +1,109 @@
+#include <arpa/inet.h>
+#include <errno.h>
+
+#include <cstring>
+
+#include "../../include/Connection.hpp"
+#include "../../include/SocketLibrary.hpp"
+
+Connection::Connection(int s, unsigned int messageCapacity)
+    : sock(s), open(true), head(0), count(0), batched(0), message(messageCapacity) {
+    ring = new char[CONNECTION_BUFFER_SIZE];
+    batch = new char[CONNECTION_BUFFER_SIZE];
+}
+
+void Connection::fill() {
+    if (!count) head = 0;
+    // The free space may wrap around the end of the ring
+    unsigned int tail = (head + count) % CONNECTION_BUFFER_SIZE;
+    iovec parts[2];
+    int numParts = 1;
+    parts[0].iov_base = ring + tail;
+    if (tail >= head && count < CONNECTION_BUFFER_SIZE) {
+        parts[0].iov_len = CONNECTION_BUFFER_SIZE - tail;
+        parts[1].iov_base = ring;
+        parts[1].iov_len = head;
+        if (head) numParts = 2;
+    } else {
+        parts[0].iov_len = head - tail;
+    }
+    size_t got = readSomeFromSocket(sock, parts, numParts);
+    if (!got) open = false;
+    count += got;
+}
+
+bool Connection::take(char *data, unsigned int size) {
+    while (size) {
+        if (!count) {
+            if (!open) return false;
+            // Read large messages straight into place
+            if (size >= CONNECTION_BUFFER_SIZE) return (open = readFromSocket(sock, data, size));
+            fill();
+            continue;
+        }
+        unsigned int chunk = count;
+        if (chunk > CONNECTION_BUFFER_SIZE - head) chunk = CONNECTION_BUFFER_SIZE - head;
+        if (chunk > size) chunk = size;
+        memcpy(data, ring + head, chunk);
+        head = (head + chunk) % CONNECTION_BUFFER_SIZE;
+        count -= chunk;
+        data += chunk;
+        size -= chunk;
+    }
+    return true;
+}
+
+void Connection::writeMessage(const char *data, unsigned int size) {
+    if (!data || !open) return;
+    uint32_t header = htonl(size);
+    if (batched + FRAME_HEADER_SIZE + size <= CONNECTION_BUFFER_SIZE) {
+        memcpy(batch + batched, &header, FRAME_HEADER_SIZE);
+        memcpy(batch + batched + FRAME_HEADER_SIZE, data, size);
+        batched += FRAME_HEADER_SIZE + size;
+        return;
+    }
+    // The message doesn't fit, so it's sent right away along with the batch
+    iovec parts[3];
+    parts[0].iov_base = batch;
+    parts[0].iov_len = batched;
+    parts[1].iov_base = &header;
+    parts[1].iov_len = FRAME_HEADER_SIZE;
+    parts[2].iov_base = (void *)data;
+    parts[2].iov_len = size;
+    open = writeVectorToSocket(sock, parts, 3);
+    batched = 0;
+}
+
+void Connection::flush() {
+    if (!batched || !open) return;
+    open = writeToSocket(sock, batch, batched);
+    batched = 0;
+}
+
+bool Connection::hasMessage() const {
+    if (count < FRAME_HEADER_SIZE) return false;
+    // The header may wrap around the end of the ring too
+    uint32_t header = 0;
+    for (unsigned int b = 0; b < FRAME_HEADER_SIZE; b++)
+        ((char *)&header)[b] = ring[(head + b) % CONNECTION_BUFFER_SIZE];
+    return count - FRAME_HEADER_SIZE >= ntohl(header);
+}
+
+char *Connection::readMessage() {
+    uint32_t header = 0;
+    if (!hasMessage()) flush();
+    if (!take((char *)&header, FRAME_HEADER_SIZE)) return NULL;
+    unsigned int size = ntohl(header);
+    if (size > MAX_MESSAGE_SIZE) {
+        // The stream can't be trusted past a corrupt header
+        errno = EMSGSIZE;
+        open = false;
+        return NULL;
+    }
+    // Room for a terminating character as well, so that text can be read as a string
+    message.reserve(size + 1);
+    if (!take(message.getData(), size)) return NULL;
+    message.getData()[size] = '\0';
+    message.setSize(size);
+    return message.getData();
+}
\ No newline at end of file
@@ -0,0 +1,37 @@
+#include <errno.h>
+#include <unistd.h>
+
+#include "../../include/AppStandards.hpp"
+#include "../../include/EventLoop.hpp"
+
+EventLoop::EventLoop() {
+    // The loop is made before the monitors are forked, which must not inherit it
+    if ((epfd = epoll_create1(EPOLL_CLOEXEC)) < 0) die("epoll/create", 19);
+}
+
+EventLoop::~EventLoop() {
+    close(epfd);
+}
+
+void EventLoop::watch(int sock, uint32_t events, void *data) {
+    epoll_event event;
+    event.events = events;
+    event.data.ptr = data;
+    if (epoll_ctl(epfd, EPOLL_CTL_ADD, sock, &event) < 0) die("epoll/ctl", 20);
+}
+
+void EventLoop::unwatch(int sock) {
+    // Older kernels need an event, even though it's ignored
+    epoll_event event = {0};
+    if (epoll_ctl(epfd, EPOLL_CTL_DEL, sock, &event) < 0) die("epoll/ctl", 20);
+}
+
+unsigned int EventLoop::wait(void **ready, unsigned int maxReady, int timeout) {
+    epoll_event events[EVENT_LOOP_MAX_EVENTS];
+    if (maxReady > EVENT_LOOP_MAX_EVENTS) maxReady = EVENT_LOOP_MAX_EVENTS;
+    int numReady = epoll_wait(epfd, events, maxReady, timeout);
+    if (numReady < 0 && errno == EINTR) return 0;
+    if (numReady < 0) die("epoll/wait", 21);
+    for (int e = 0; e < numReady; e++) ready[e] = events[e].data.ptr;
+    return numReady;
+}
\ No newline at end of file
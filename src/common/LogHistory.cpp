@@ -7,7 +7,8 @@
 #include "../../include/LogHistory.hpp"
 
 void writeLogFile(List<std::string> countryList, std::string dirName,
-                  mode_t permissions, unsigned int acc, unsigned int rej) {
+                  mode_t permissions, unsigned int acc, unsigned int rej,
+                  const std::string &extra) {
     std::string fileName(dirName + "log_file."), line;
     fileName.append(toString(getpid()));
     struct stat buf;
@@ -31,6 +32,7 @@ void writeLogFile(List<std::string> countryList, std::string dirName,
     line.append("TOTAL TRAVEL REQUESTS " + toString(acc + rej) + '\n' +
                 "ACCEPTED " + toString(acc) + '\n' +
                 "REJECTED " + toString(rej) + '\n');
+    line.append(extra);
 
     std::ofstream logFile(fileName);
     logFile << line;        
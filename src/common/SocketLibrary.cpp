@@ -2,6 +2,7 @@
 #include <fcntl.h>
 #include <sys/stat.h>
 #include <sys/types.h>
+#include <sys/uio.h>
 #include <unistd.h>
 
 #include "../../include/AppStandards.hpp"
@@ -23,24 +24,99 @@ void listenConnections(int sockfd, int maxConn) {
 
 int acceptConnection(int sockfd, sockaddr *addr, socklen_t *len) {
     int newsock = 0;
-    if ((newsock = accept(sockfd, addr, len)) < 0) die("socket/accept", 14);
+    socklen_t addrLen = *len;
+    // A client may give up on its connection before it's accepted
+    while ((newsock = accept(sockfd, addr, len)) < 0 && (errno == EINTR || errno == ECONNABORTED))
+        *len = addrLen;
+    // A listening socket that was shut down fails with EINVAL
+    if (newsock < 0 && errno == EINVAL) return -1;
+    if (newsock < 0) die("socket/accept", 14);
     return newsock;
 }
 
+void stopListening(int sockfd) {
+    // ENOTCONN when another thread shut it down already
+    if (shutdown(sockfd, SHUT_RDWR) < 0 && errno != ENOTCONN) die("socket/shutdown", 22);
+}
+
 void closeSocket(int sock) {
     if (close(sock) < 0) die("socket/close", 15);
 }
 
-void writeToSocket(int sockfd, void *message, size_t bufferSize) {
-    if (send(sockfd, message, bufferSize, 0) < 0) {
-        perror("socket/send");
-        exit(16);
+void abortSocket(int sock) {
+    linger reset = {1, 0};
+    if (setsockopt(sock, SOL_SOCKET, SO_LINGER, &reset, sizeof(reset)) < 0) die("socket/setsockopt", 23);
+    closeSocket(sock);
+}
+
+bool connectedToItself(int sockfd) {
+    sockaddr_in local = {0}, peer = {0};
+    socklen_t localLen = sizeof(local), peerLen = sizeof(peer);
+    if (getsockname(sockfd, (sockaddr *)&local, &localLen) < 0) die("socket/getsockname", 24);
+    // Not connected after all
+    if (getpeername(sockfd, (sockaddr *)&peer, &peerLen) < 0) return false;
+    return local.sin_port == peer.sin_port && local.sin_addr.s_addr == peer.sin_addr.s_addr;
+}
+
+void setBlocking(int sock, bool blocking) {
+    int flags = 0;
+    if ((flags = fcntl(sock, F_GETFL)) < 0) die("socket/fcntl", 18);
+    flags = blocking ? (flags & ~O_NONBLOCK) : (flags | O_NONBLOCK);
+    if (fcntl(sock, F_SETFL, flags) < 0) die("socket/fcntl", 18);
+}
+
+bool writeToSocket(int sockfd, const void *message, size_t bufferSize) {
+    const char *data = (const char *)message;
+    while (bufferSize) {
+        // A closed connection fails with EPIPE rather than raising SIGPIPE
+        ssize_t sent = send(sockfd, data, bufferSize, MSG_NOSIGNAL);
+        if (sent < 0 && errno == EINTR) continue;
+        if (sent < 0) return false;
+        data += sent;
+        bufferSize -= sent;
+    }
+    return true;
+}
+
+bool writeVectorToSocket(int sockfd, iovec *parts, int count) {
+    msghdr msg = {0};
+    while (count) {
+        msg.msg_iov = parts;
+        msg.msg_iovlen = count;
+        ssize_t sent = sendmsg(sockfd, &msg, MSG_NOSIGNAL);
+        if (sent < 0 && errno == EINTR) continue;
+        if (sent < 0) return false;
+        // Skip the parts that were sent whole, then what was sent of the next one
+        while (count && (size_t)sent >= parts->iov_len) {
+            sent -= parts->iov_len;
+            parts++;
+            count--;
+        }
+        if (count) {
+            parts->iov_base = (char *)parts->iov_base + sent;
+            parts->iov_len -= sent;
+        }
     }
+    return true;
+}
+
+size_t readSomeFromSocket(int sockfd, iovec *parts, int count) {
+    ssize_t got = 0;
+    while ((got = readv(sockfd, parts, count)) < 0 && errno == EINTR);
+    if (got < 0) return 0;
+    // The other end closed the connection in the middle of the protocol
+    if (!got) errno = ECONNRESET;
+    return got;
 }
 
-void readFromSocket(int sockfd, void *message, size_t bufferSize) {
-    if (recv(sockfd, message, bufferSize, 0) < 0) {
-        perror("socket/recv");
-        exit(17);
+bool readFromSocket(int sockfd, void *message, size_t bufferSize) {
+    char *data = (char *)message;
+    while (bufferSize) {
+        iovec part = {data, bufferSize};
+        size_t got = readSomeFromSocket(sockfd, &part, 1);
+        if (!got) return false;
+        data += got;
+        bufferSize -= got;
     }
+    return true;
 }
\ No newline at end of file
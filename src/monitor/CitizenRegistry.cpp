@@ -0,0 +1,63 @@
+#include "include/CitizenRegistry.hpp"
+#include "../../include/DataManipulationLib.hpp"
+
+CitizenRegistry::CitizenRegistry(unsigned int limit, unsigned int tableSize)
+    : denseLimit(limit), usedPages(0), denseEntries(0), sparseTable(tableSize), totalEntries(0) {
+    numPages = (denseLimit + REGISTRY_PAGE_SIZE - 1) / REGISTRY_PAGE_SIZE;
+    pages = new registryPage *[numPages ? numPages : 1];
+    sparsePages = new bool[numPages ? numPages : 1];
+    for (unsigned int page = 0; page < numPages; page++) {
+        pages[page] = NULL;
+        sparsePages[page] = false;
+    }
+}
+
+CitizenRegistry::~CitizenRegistry() {
+    for (unsigned int page = 0; page < numPages; page++) delete pages[page];
+    delete[] pages;
+    delete[] sparsePages;
+}
+
+bool CitizenRegistry::preparePage(unsigned int id) {
+    unsigned int page = id / REGISTRY_PAGE_SIZE;
+    if (pages[page]) return true;
+    if (usedPages * REGISTRY_PAGE_SIZE > REGISTRY_MAX_SPARSITY * denseEntries) {
+        sparsePages[page] = true;
+        return false;
+    }
+    pages[page] = new registryPage();
+    usedPages++;
+    return true;
+}
+
+Person *CitizenRegistry::insert(const Person &person) {
+    Person *personPtr = search(person.ID());
+    if (personPtr) return personPtr;
+
+    if (!isDense(person.ID()) || !preparePage(person.ID())) {
+        std::string key(toString(person.ID()));
+        sparseTable.insert(key, person);
+        totalEntries++;
+        return sparseTable.search(key, person);
+    }
+
+    unsigned int page = person.ID() / REGISTRY_PAGE_SIZE;
+    unsigned int slot = person.ID() % REGISTRY_PAGE_SIZE;
+    pages[page]->slots[slot] = person;
+    pages[page]->used[slot] = true;
+    denseEntries++;
+    totalEntries++;
+    return &pages[page]->slots[slot];
+}
+
+Person *CitizenRegistry::search(unsigned int id) {
+    if (!isDense(id)) {
+        Person person;
+        person.setID(id);
+        return sparseTable.search(toString(id), person);
+    }
+
+    registryPage *pagePtr = pages[id / REGISTRY_PAGE_SIZE];
+    if (!pagePtr || !pagePtr->used[id % REGISTRY_PAGE_SIZE]) return NULL;
+    return &pagePtr->slots[id % REGISTRY_PAGE_SIZE];
+}
\ No newline at end of file
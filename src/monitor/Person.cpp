@@ -1,3 +1,5 @@
+#include <utility>
+
 #include "include/Person.hpp"
 
 Person::Person(const Person &person) {
@@ -9,6 +11,10 @@ Person::Person(const Person &person) {
     age = person.getAge();
 }
 
+Person::Person(Person &&person)
+    : id(person.id), firstName(std::move(person.firstName)),
+      lastName(std::move(person.lastName)), country(person.country), age(person.age) {}
+
 Person &Person::operator=(const Person &person) {
     if (this == &person) return *this;
     id = person.ID();
@@ -19,7 +25,17 @@ Person &Person::operator=(const Person &person) {
     return *this;
 }
 
-void Person::set(unsigned int id, std::string name, std::string surname,
+Person &Person::operator=(Person &&person) {
+    if (this == &person) return *this;
+    id = person.id;
+    firstName = std::move(person.firstName);
+    lastName = std::move(person.lastName);
+    country = person.country;
+    age = person.age;
+    return *this;
+}
+
+void Person::set(unsigned int id, const std::string &name, const std::string &surname,
                  Country *country, unsigned int age) {
     this->id = id;
     firstName = name;
@@ -3,13 +3,22 @@
 Record::Record(const Record &record) {
     if (this == &record) return;
     citizenID = record.ID();
-    date = record.getDate();
+    date = record.date;
 }
 
+Record::Record(Record &&record) : citizenID(record.citizenID), date(record.date) {}
+
 Record &Record::operator=(const Record &record) {
     if (this == &record) return *this;
     citizenID = record.ID();
-    date = record.getDate();
+    date = record.date;
+    return *this;
+}
+
+Record &Record::operator=(Record &&record) {
+    if (this == &record) return *this;
+    citizenID = record.citizenID;
+    date = record.date;
     return *this;
 }
 
@@ -47,7 +56,7 @@ void Record::set(unsigned int id, Date date) {
     this->date = date;
 }
 
-void Record::set(unsigned int id, std::string dateStr) {
+void Record::set(unsigned int id, const std::string &dateStr) {
     this->citizenID = id;
     this->date.set(dateStr);
 }
\ No newline at end of file
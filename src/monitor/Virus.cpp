@@ -1,21 +1,152 @@
+#include <utility>
+
 #include "include/Virus.hpp"
+#include "../../include/BloomDelta.hpp"
+#include "../../include/DataManipulationLib.hpp"
 
-Virus::Virus(const Virus &virus) {
-    if (this == &virus) return;
-    name.clear();
-    name.assign(virus.getName());
-}
+// Number of records read at once from the vaccinated list while refilling a filter
+#define FILL_BATCH 1024
+
+Virus::Virus(const Virus &virus)
+    : name(virus.name), id(virus.id), counters(virus.counters), filter(virus.filter),
+      vaccinatedList(virus.vaccinatedList), nonVaccinatedList(virus.nonVaccinatedList) {}
+
+Virus::Virus(Virus &&virus)
+    : name(std::move(virus.name)), id(virus.id), counters(std::move(virus.counters)),
+      filter(std::move(virus.filter)),
+      vaccinatedList(std::move(virus.vaccinatedList)),
+      nonVaccinatedList(std::move(virus.nonVaccinatedList)) {}
 
 Virus &Virus::operator=(const Virus &virus) {
     if (this == &virus) return *this;
     name.clear();
     name.assign(virus.getName());
+    id = virus.id;
+    counters = virus.counters;
     filter = virus.filter;
     vaccinatedList = virus.vaccinatedList;
     nonVaccinatedList = virus.nonVaccinatedList;
     return *this;
 }
 
+Virus &Virus::operator=(Virus &&virus) {
+    if (this == &virus) return *this;
+    name = std::move(virus.name);
+    id = virus.id;
+    counters = std::move(virus.counters);
+    filter = std::move(virus.filter);
+    vaccinatedList = std::move(virus.vaccinatedList);
+    nonVaccinatedList = std::move(virus.nonVaccinatedList);
+    return *this;
+}
+
+template <typename F>
+void Virus::fillBloom(F &bloom) const {
+    List<Record> records;
+    for (int pos = 0; pos < vaccinatedList.getSize(); pos += FILL_BATCH) {
+        vaccinatedList.page(pos, FILL_BATCH, records);
+        while (!records.empty()) {
+            bloom.insert(records.getFirst().ID());
+            records.popFirst();
+        }
+    }
+}
+
+void Virus::fitBloom() {
+    if (filter.getLayers()) return;
+    counters.resize(vaccinatedList.getSize());
+    counters.addFirstLayer();
+    fillBloom(counters);
+}
+
+#ifdef BLOCKED_BLOOM
+// Inserts the IDs that fillBloom passes in a layer of the blocked filter, if
+// that's the newest layer of counters that has them. Every ID goes to a single
+// layer, otherwise the small old layers fill up with the false positives of
+// their counters, and the client checks them all anyway.
+struct layerCollector {
+    ScalableBloomFilter<CountingBloomFilter> *counters;
+    int layer;
+    VirusFilter *filter;
+    layerCollector(ScalableBloomFilter<CountingBloomFilter> *c, int l, VirusFilter *f)
+        : counters(c), layer(l), filter(f) {}
+    void insert(unsigned int id) { if (counters->newestLayer(id) == layer) filter->insert(id); }
+};
+#endif
+
+int Virus::exportBloom(unsigned int layer, char *&deltas) {
+    CountingBloomFilter *layerCounters = counters.getLayer(layer);
+    unsigned int bytes = layerCounters->getSize() / BITS_IN_BYTE;
+    VirusFilter *previous = filter.getLayer(layer);
+    deltas = NULL;
+#ifdef BLOCKED_BLOOM
+    // Which IDs go to a blocked layer depends on the counters of that layer and
+    // of the newer ones. Those are exported after it, so their marks are still set.
+    bool dirty = false;
+    for (unsigned int l = layer; l < counters.getLayers(); l++)
+        if (counters.getLayer(l)->getDirtyWords()) dirty = true;
+    if (previous && !dirty) return 0;
+    // The blocked filter ignores the number of hash functions of the counters
+    // and always uses BLOOM_BLOCK_LANES, which is what is sent for it.
+    // It probes other positions than the counters, so it can only be built
+    // from the records themselves.
+    VirusFilter current(bytes, layerCounters->getFunctionsNumber());
+    layerCollector collector(&counters, layer, &current);
+    fillBloom(collector);
+    layerCounters->clearDirty();
+    int changed = -1;
+    if (previous && current.getSize() == previous->getSize()) {
+        bytes = current.getSize() / BITS_IN_BYTE;
+        deltas = new char[bloomDeltaCapacity(bytes)];
+        changed = bloomDiff(previous->getArray(), current.getArray(), bytes, deltas);
+    }
+    *filter.setLayer(layer, current.getSize() / BITS_IN_BYTE, current.getFunctionsNumber()) = std::move(current);
+    return changed;
+#else
+    // Only the words whose counters were touched since the previous export may differ
+    if (previous && previous->getSize() == layerCounters->getSize() &&
+        previous->getFunctionsNumber() == layerCounters->getFunctionsNumber()) {
+        if (!layerCounters->getDirtyWords()) return 0;
+        deltas = new char[layerCounters->getDirtyWords() * BLOOM_DELTA_SIZE];
+        return layerCounters->exportChanges(*previous, deltas);
+    }
+    layerCounters->exportTo(*filter.setLayer(layer, bytes, layerCounters->getFunctionsNumber()));
+    return -1;
+#endif
+}
+
+// Collects the IDs that fillBloom inserts in an array
+struct idCollector {
+    unsigned int *ids;
+    unsigned int size;
+    idCollector(unsigned int capacity) : ids(new unsigned int[capacity ? capacity : 1]), size(0) {}
+    ~idCollector() { delete[] ids; }
+    void insert(unsigned int id) { ids[size++] = id; }
+};
+
+bool Virus::exportXor(XorFilter &xorFilter) const {
+    idCollector collector(vaccinatedList.getSize());
+    fillBloom(collector);
+    return xorFilter.build(collector.ids, collector.size);
+}
+
+void Virus::exportRoaring(RoaringBitmap &bitmap) const {
+    bitmap.flush();
+    fillBloom(bitmap);
+}
+
+void Virus::vaccinate(const Record &record) {
+    nonVaccinatedList.remove(record.ID());
+    vaccinatedList.insert(record);
+    counters.insert(record.ID());
+}
+
+void Virus::unvaccinate(const Record &record) {
+    counters.remove(record.ID());
+    vaccinatedList.remove(record);
+    nonVaccinatedList.insert(record.ID());
+}
+
 bool operator==(const Virus &v1, const Virus &v2) {
     return (v1.getName() == v2.getName());
 }
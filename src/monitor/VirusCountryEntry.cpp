@@ -5,6 +5,7 @@ VirusCountryEntry::VirusCountryEntry(const VirusCountryEntry &entry) {
     virus = entry.virus;
     country = entry.country;
     totalRegistered = entry.getTotalRegistered();
+    totalVaccinated = entry.getTotalVaccinated();
     total_0_20 = entry.getTotal_0_20();
     total_20_40 = entry.getTotal_20_40();
     total_40_60 = entry.getTotal_40_60();
@@ -20,6 +21,7 @@ VirusCountryEntry &VirusCountryEntry::operator=(const VirusCountryEntry &entry)
     virus = entry.virus;
     country = entry.country;
     totalRegistered = entry.getTotalRegistered();
+    totalVaccinated = entry.getTotalVaccinated();
     total_0_20 = entry.getTotal_0_20();
     total_20_40 = entry.getTotal_20_40();
     total_40_60 = entry.getTotal_40_60();
@@ -35,6 +37,7 @@ void VirusCountryEntry::set(Virus *v, Country *c) {
     virus = v;
     country = c;
     totalRegistered = 0;
+    totalVaccinated = 0;
     total_0_20 = 0;
     total_20_40 = 0;
     total_40_60 = 0;
@@ -84,6 +87,21 @@ void VirusCountryEntry::registerPerson(unsigned int age, std::string status) {
     }
 }
 
+void VirusCountryEntry::changeStatus(unsigned int age, bool vaccinated) {
+    if (age <= 0) return;
+    // A registered person becomes vaccinated (+1) or not vaccinated (-1)
+    int step = vaccinated ? 1 : -1;
+    totalVaccinated += step;
+    if (age <= 20)
+        vaccinated_0_20 += step;
+    else if (age <= 40)
+        vaccinated_20_40 += step;
+    else if (age <= 60)
+        vaccinated_40_60 += step;
+    else
+        vaccinated_60_plus += step;
+}
+
 bool operator==(const VirusCountryEntry &e1, const VirusCountryEntry &e2) {
     return (*e1.virus == *e2.virus && *e1.country == *e2.country);
 }
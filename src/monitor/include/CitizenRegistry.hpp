@@ -0,0 +1,55 @@
+#ifndef CITIZENREGISTRY_HPP
+#define CITIZENREGISTRY_HPP
+
+#include "../../../include/HashTable.hpp"
+#include "Person.hpp"
+
+#define REGISTRY_PAGE_SIZE 1024
+#define REGISTRY_MAX_SPARSITY 16  // Slots the pages may hold per citizen in them
+
+// Stores every known citizen, looked up by the numeric citizenID.
+// IDs below denseLimit are indexed directly into pages of Person slots,
+// which are only allocated when the first citizen of their range arrives.
+// A range whose first citizen arrives while the pages hold more than
+// REGISTRY_MAX_SPARSITY slots per citizen gets no page, so that sparse IDs
+// don't allocate a page each. Its citizens, and any ID from denseLimit on,
+// fall back to a hash table keyed by the ID string.
+// A denseLimit of 0 disables the direct indexing completely.
+class CitizenRegistry {
+   private:
+    struct registryPage {
+        Person slots[REGISTRY_PAGE_SIZE];
+        bool used[REGISTRY_PAGE_SIZE];
+        registryPage() { for (unsigned int i = 0; i < REGISTRY_PAGE_SIZE; i++) used[i] = false; }
+    };
+    unsigned int denseLimit;
+    unsigned int numPages;
+    registryPage **pages;
+    bool *sparsePages;  // Ranges below denseLimit that were left to the table
+    unsigned int usedPages;
+    unsigned int denseEntries;
+    HashTable<Person> sparseTable;
+    unsigned int totalEntries;
+
+    bool isDense(unsigned int id) const { return id < denseLimit && !sparsePages[id / REGISTRY_PAGE_SIZE]; }
+    // Allocates the page of the range of id, unless the pages are already too
+    // sparse, and leaves the range to the table then. True if it has a page.
+    bool preparePage(unsigned int id);
+
+    CitizenRegistry(const CitizenRegistry &registry);
+    CitizenRegistry &operator=(const CitizenRegistry &registry);
+
+   public:
+    CitizenRegistry(unsigned int limit, unsigned int tableSize);
+    ~CitizenRegistry();
+
+    unsigned int getTotalEntries() const { return totalEntries; }
+    unsigned int getDenseLimit() const { return denseLimit; }
+
+    // Stores a copy of the person, unless a person with the same ID
+    // is already registered, and returns the registered one
+    Person *insert(const Person &person);
+    Person *search(unsigned int id);
+};
+
+#endif
\ No newline at end of file
@@ -18,7 +18,9 @@ class Person {
     Person() : id(0), firstName(""), lastName(""), country(NULL), age(0) {}
     ~Person() {}
     Person(const Person &person);
+    Person(Person &&person);
     Person &operator=(const Person &person);
+    Person &operator=(Person &&person);
 
     unsigned int ID() const { return id; }
     std::string getFirstName() const { return firstName; }
@@ -27,10 +29,10 @@ class Person {
     unsigned int getAge() const { return age; }
 
     void setID(unsigned int i) { id = i; }
-    void setName(std::string name) { firstName = name; }
-    void setSurname(std::string surname) { lastName = surname; }
+    void setName(const std::string &name) { firstName = name; }
+    void setSurname(const std::string &surname) { lastName = surname; }
     void setCountry(Country *c) { country = c; }
-    void set(unsigned int id, std::string name, std::string surname,
+    void set(unsigned int id, const std::string &name, const std::string &surname,
              Country *country, unsigned int age);
 
     friend bool operator==(const Person &p1, const Person &p2);
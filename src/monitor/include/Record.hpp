@@ -14,7 +14,9 @@ class Record {
     Record(int id = 0) : citizenID(id) {}
     ~Record() {}
     Record(const Record &record);
+    Record(Record &&record);
     Record &operator=(const Record &record);
+    Record &operator=(Record &&record);
 
     unsigned int ID() const { return citizenID; }
     std::string getDate() const {
@@ -22,12 +24,13 @@ class Record {
         date.get(str);
         return str;
     }
+    uint32_t packedDate() const { return date.pack(); }
 
     void setID(unsigned int id) { citizenID = id; }
     void setDate(Date &d) { date = d; }
 
     void set(unsigned int id, Date date);
-    void set(unsigned int id, std::string dateStr);
+    void set(unsigned int id, const std::string &dateStr);
 
     friend bool operator==(const Record &r1, const Record &r2);
     friend bool operator!=(const Record &r1, const Record &r2);
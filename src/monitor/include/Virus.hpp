@@ -3,49 +3,99 @@
 
 #include <iostream>
 
-#include "../../../include/BloomFilter.hpp"
+#include "../../../include/CountingBloomFilter.hpp"
+#include "../../../include/RoaringBitmap.hpp"
+#include "../../../include/ScalableBloomFilter.hpp"
+#include "../../../include/VirusFilter.hpp"
+#include "../../../include/XorFilter.hpp"
 #include "../../../include/SkipList.hpp"
 #include "Record.hpp"
 
 class Virus {
    private:
     std::string name;
-    BloomFilter filter;
+    unsigned int id;  // Interned, as the virus is named in queries (see QueryProtocol.hpp)
+    // The monitor keeps counters so that records can be removed as well,
+    // and exports the plain filter that is sent to the travelClient.
+    // Both grow by a layer at a time, as the records do.
+    ScalableBloomFilter<CountingBloomFilter> counters;
+    ScalableBloomFilter<VirusFilter> filter;  // As it was last exported
     SkipList<Record> vaccinatedList;
     SkipList<int> nonVaccinatedList;
 
    public:
-    Virus() : name("") {}
-    Virus(unsigned int bloomSize) : name(""), filter(bloomSize) {}
+    Virus() : name(""), id(0) {}
+    // The first layer is bloomSize bytes, until fitBloom, and all of them together keep the given false
+    // positive rate. It's there from the start, so that a virus with no vaccinated records is sent all the same.
+    Virus(unsigned int bloomSize, double fpr) : name(""), id(0), counters(bloomSize, fpr) { counters.addFirstLayer(); }
     ~Virus() {}
     Virus(const Virus &virus);
+    Virus(Virus &&virus);
     Virus &operator=(const Virus &virus);
+    Virus &operator=(Virus &&virus);
 
     std::string getName() const { return name; }
-    unsigned int getBloomSize() const { return filter.getSize(); }
+    unsigned int getID() const { return id; }
+    unsigned int getBloomLayers() const { return counters.getLayers(); }
+    // Size of the array of a layer in bytes, as it's sent to the travelClient
+    unsigned int getBloomBytes(unsigned int layer) { return filter.getLayer(layer)->getSize() / BITS_IN_BYTE; }
+    unsigned int getBloomFunctions(unsigned int layer) { return filter.getLayer(layer)->getFunctionsNumber(); }
     unsigned int getVaccinatedListSize() const { return vaccinatedList.getSize(); }
     unsigned int getNonVaccinatedListSize() const { return nonVaccinatedList.getSize(); }
 
     void setName(const std::string &str) { name = str; }
-    void initializeBloom(const Virus &virus) { filter = virus.filter; }
-    void copyBloom(BloomFilter &bloom) { bloom = filter; }
+    void setID(unsigned int i) { id = i; }
+    void initializeBloom(const Virus &virus) { counters = virus.counters; filter = virus.filter; }
 
-    void insertBloom(const std::string &str) { filter.insert(str); }
-    bool checkBloom(const std::string &str) { return filter.check(str); }
-    void bloomStatus() const { filter.arrayStatus(); }
-    char *getBloom() const { return filter.getArray(); }
+    void insertBloom(unsigned int id) { counters.insert(id); }
+    void removeBloom(unsigned int id) { counters.remove(id); }
+    bool checkBloom(unsigned int id) { return counters.check(id); }
+    // Sizes the first layer of the counters for the vaccinated records, with the
+    // same false positive rate, and inserts them again. Only a virus that was
+    // never exported is resized, since the travelClients hold its layers afterwards.
+    void fitBloom();
+    // Refreshes a layer of the filter that is sent to the travelClient from the
+    // counters. Returns the number of words that changed since the previous
+    // export and allocates deltas to hold them (see BloomDelta.hpp), or -1 when
+    // the layer is exported for the first time and must be sent whole.
+    int exportBloom(unsigned int layer, char *&deltas);
+    // Builds a static xor filter of the vaccinated list. False if that failed.
+    bool exportXor(XorFilter &xorFilter) const;
+    // Stores the IDs of the vaccinated list in given bitmap
+    void exportRoaring(RoaringBitmap &bitmap) const;
+    void bloomStatus() {
+        for (unsigned int layer = 0; layer < counters.getLayers(); layer++) counters.getLayer(layer)->arrayStatus();
+    }
+    char *getBloom(unsigned int layer) { return filter.getLayer(layer)->getArray(); }
 
     void insertVaccinatedList(const Record &record) { vaccinatedList.insert(record); }
     void insertNonVaccinatedList(const int id) { nonVaccinatedList.insert(id); }
     void removeVaccinatedList(const Record &record) { vaccinatedList.remove(record); }
     void removeNonVaccinatedList(const int id) { nonVaccinatedList.remove(id); }
+    // Moves a citizen between the two lists, keeping the counters up to date
+    void vaccinate(const Record &record);
+    void unvaccinate(const Record &record);
 
     Record *searchVaccinatedList(const Record record) { return vaccinatedList.search(record); }
     int *searchNonVaccinatedList(const int id) { return nonVaccinatedList.search(id); }
     // Used to read each record of the skiplist at given position
     Record *getPositiveRecordNumber(unsigned int num) { return vaccinatedList.getNode(num); }
     int *getNegativeRecordNumber(unsigned int num) { return nonVaccinatedList.getNode(num); }
+    // Used to read the vaccinated records ordered by citizenID, in ranges or pages
+    int vaccinatedRank(const Record &record) const { return vaccinatedList.rank(record); }
+    int getVaccinatedRange(const Record &low, const Record &high, List<Record> &result) const {
+        return vaccinatedList.range(low, high, result);
+    }
+    int getVaccinatedPage(int pos, int count, List<Record> &result) const {
+        return vaccinatedList.page(pos, count, result);
+    }
 
+   private:
+    // Inserts the IDs of all vaccinated records in given filter
+    template <typename F>
+    void fillBloom(F &bloom) const;
+
+   public:
     friend bool operator==(const Virus &v1, const Virus &v2);
     friend bool operator!=(const Virus &v1, const Virus &v2);
     friend bool operator<(const Virus &v1, const Virus &v2);
@@ -42,6 +42,8 @@ class VirusCountryEntry {
 
     void set(Virus *v, Country *c);
     void registerPerson(unsigned int age, std::string status);
+    // Moves an already registered person between vaccinated and not vaccinated
+    void changeStatus(unsigned int age, bool vaccinated);
 
     friend bool operator==(const VirusCountryEntry &e1, const VirusCountryEntry &e2);
     friend bool operator!=(const VirusCountryEntry &e1, const VirusCountryEntry &e2);
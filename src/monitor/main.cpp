@@ -5,16 +5,23 @@
 #include <iomanip>
 
 #include "../../include/AppStandards.hpp"
+#include "../../include/BloomDelta.hpp"
+#include "../../include/BloomEncoding.hpp"
 #include "../../include/BloomFilter.hpp"
+#include "../../include/Connection.hpp"
 #include "../../include/DataManipulationLib.hpp"
 #include "../../include/Date.hpp"
 #include "../../include/HashTable.hpp"
 #include "../../include/List.hpp"
 #include "../../include/LogHistory.hpp"
-#include "../../include/Messaging.hpp"
+#include "../../include/QueryProtocol.hpp"
 #include "../../include/Queue.hpp"
+#include "../../include/RoaringBitmap.hpp"
 #include "../../include/SkipList.hpp"
+#include "../../include/SortedArray.hpp"
 #include "../../include/SocketLibrary.hpp"
+#include "../../include/XorFilter.hpp"
+#include "include/CitizenRegistry.hpp"
 #include "include/Country.hpp"
 #include "include/Person.hpp"
 #include "include/Record.hpp"
@@ -43,24 +50,44 @@ struct recordObject {
     Record record;
     VirusCountryEntry vCountryEntry;
     Date date1, date2;
-    // Constructor to set up the desired bloom size for every virus bloom filter
+    // Constructor to set up the desired bloom size for the first layer of every virus bloom filter
     // Note that we will NOT insert any citizen in this virus filter!!
-    recordObject(unsigned int bloomSize) : virus(bloomSize) {}
+    recordObject(unsigned int bloomSize) : virus(bloomSize, BLOOM_TARGET_FPR) {}
 };
 
 // Basic data structrures that implement the database of the app
 struct appDataBase {
-    // A table that hold all the citizen information
-    HashTable<Person> citizenRegistry;
-    // A list with all known viruses
-    List<Virus> virusList;
-    // A list with all known countries
-    List<Country> countryList;
+    // A registry that holds all the citizen information
+    CitizenRegistry citizenRegistry;
+    // All known viruses, sorted by name
+    SortedArray<Virus> virusList;
+    // The same viruses by the id they are interned with, which
+    // is the order they were first read in (see QueryProtocol.hpp)
+    Virus **virusIDs;
+    unsigned int numVirusIDs, virusIDsCapacity;
+    // All known countries, sorted by name
+    SortedArray<Country> countryList;
     // A table with entries that associate virus statistics for every country
     HashTable<VirusCountryEntry> entriesTable;
-    appDataBase(unsigned int pTableSize = CITIZEN_REGISTRY_SIZE,
+    appDataBase(unsigned int denseLimit = DENSE_REGISTRY_LIMIT,
+        unsigned int pTableSize = CITIZEN_REGISTRY_SIZE,
         unsigned int entryTableSize = VIRUS_COUNTRY_ENTRIES)
-        : citizenRegistry(pTableSize), entriesTable(entryTableSize) {}
+        : citizenRegistry(denseLimit, pTableSize), virusIDs(new Virus *[SORTED_ARRAY_CAPACITY]),
+          numVirusIDs(0), virusIDsCapacity(SORTED_ARRAY_CAPACITY), entriesTable(entryTableSize) {}
+    ~appDataBase() { delete[] virusIDs; }
+
+    // Gives a new virus the next id
+    void internVirus(Virus *virusPtr) {
+        if (numVirusIDs == virusIDsCapacity) {
+            Virus **grown = new Virus *[virusIDsCapacity *= 2];
+            memcpy(grown, virusIDs, numVirusIDs * sizeof(Virus *));
+            delete[] virusIDs;
+            virusIDs = grown;
+        }
+        virusPtr->setID(numVirusIDs);
+        virusIDs[numVirusIDs++] = virusPtr;
+    }
+    Virus *searchVirus(unsigned int id) const { return (id < numVirusIDs) ? virusIDs[id] : NULL; }
 };
 
 // Statistics for files read
@@ -154,7 +181,7 @@ static bool testRecord(string &line, recordInfo &recInfo, recordObject &obj, app
         // If that's NOT the first record from this country, check out this person's info
         obj.person.set(myStoi(recInfo.idStr), recInfo.firstName,
                        recInfo.lastName, countryPtr, myStoi(recInfo.ageStr));
-        Person *personPtr = db.citizenRegistry.search(recInfo.idStr, obj.person);
+        Person *personPtr = db.citizenRegistry.search(obj.person.ID());
         if (personPtr)  // If this ID is already in the registry, validate all the rest person's info
             if (!personPtr->isIdentical(obj.person)) return false;
     }
@@ -164,6 +191,27 @@ static bool testRecord(string &line, recordInfo &recInfo, recordObject &obj, app
 }
 
 // Returns true on successfull import and false if the record was a duplicate
+// Applies a record that changes the vaccination status of a citizen who is
+// already known for this virus, in place. The statistics of the citizen are
+// updated in the entry of the country and age they were first registered with.
+bool updateRecordStatus(recordInfo &recInfo, recordObject &obj, appDataBase &db, Virus *virusPtr) {
+    Person *personPtr = db.citizenRegistry.search(obj.record.ID());
+    if (!personPtr) return false;
+    Country &country = personPtr->getCountry();
+    obj.vCountryEntry.set(virusPtr, &country);
+    VirusCountryEntry *entryPtr =
+        db.entriesTable.search(recInfo.virusName + country.getName(), obj.vCountryEntry);
+    if (!entryPtr) return false;
+
+    bool vaccinated = !recInfo.status.compare("YES");
+    if (vaccinated)
+        virusPtr->vaccinate(obj.record);
+    else
+        virusPtr->unvaccinate(obj.record);
+    entryPtr->changeStatus(personPtr->getAge(), vaccinated);
+    return true;
+}
+
 bool insertNewRecord(recordInfo &recInfo, recordObject &obj, appDataBase &db) {
     // ========== Duplicates check - Start ==========
 
@@ -174,18 +222,20 @@ bool insertNewRecord(recordInfo &recInfo, recordObject &obj, appDataBase &db) {
     // Look for the appropriate virus
     Virus *virusPtr = db.virusList.search(obj.virus);
     if (!virusPtr) {  // If that's the first time we see this virus, insert it as new
-        db.virusList.insertAscending(obj.virus);
-        // Search again for it, as it should be in the list now
-        virusPtr = db.virusList.search(obj.virus);
+        virusPtr = db.virusList.insert(obj.virus);
         // Initialize this virus filter by copying the virus prototype (required for bloomSize)
         virusPtr->initializeBloom(obj.virus);
+        db.internVirus(virusPtr);
     } else {  // In this case we need to check if this is a duplicate record
-        // If the person already has a record in EITHER of the two
-        // skip lists, or the bloom filter, then this is a duplicate record
-        if (virusPtr->checkBloom(recInfo.idStr))
-            // Attempt to save some time by asking the filter first and not the skip list
-            if (virusPtr->searchVaccinatedList(obj.record)) return false;
-        if (virusPtr->searchNonVaccinatedList(myStoi(recInfo.idStr))) return false;
+        // If the person already has a record with the same status in
+        // the appropriate skip list, then this is a duplicate record.
+        // A record with the other status updates the person's record instead.
+        bool vaccinated = !recInfo.status.compare("YES");
+        // Attempt to save some time by asking the filter first and not the skip list
+        if (virusPtr->checkBloom(obj.record.ID()) && virusPtr->searchVaccinatedList(obj.record))
+            return vaccinated ? false : updateRecordStatus(recInfo, obj, db, virusPtr);
+        if (virusPtr->searchNonVaccinatedList(myStoi(recInfo.idStr)))
+            return vaccinated ? updateRecordStatus(recInfo, obj, db, virusPtr) : false;
     }
 
     // =========== Duplicates check - End ===========
@@ -196,7 +246,7 @@ bool insertNewRecord(recordInfo &recInfo, recordObject &obj, appDataBase &db) {
     if (!recInfo.status.compare("YES")) {
         // For positive records we insert both, in the bloom filter
         // and the vaccinated skip list of the current virus
-        virusPtr->insertBloom(recInfo.idStr);
+        virusPtr->insertBloom(obj.record.ID());
         virusPtr->insertVaccinatedList(obj.record);
     } else {
         // Insert in non-vaccinated skip-list.
@@ -211,19 +261,14 @@ bool insertNewRecord(recordInfo &recInfo, recordObject &obj, appDataBase &db) {
     // Look for the appropriate country
     obj.country.setName(recInfo.countryName);
     Country *countryPtr = db.countryList.search(obj.country);
-    if (!countryPtr) {
-        // If that's the first citizen, create the new country
-        db.countryList.insertAscending(obj.country);
-        // Search again for it, as it should be in the list now
-        countryPtr = db.countryList.search(obj.country);
-    }
+    // If that's the first citizen, create the new country
+    if (!countryPtr) countryPtr = db.countryList.insert(obj.country);
 
     // Set up the person object
     obj.person.set(myStoi(recInfo.idStr), recInfo.firstName,
                    recInfo.lastName, countryPtr, myStoi(recInfo.ageStr));
-    Person *personPtr = db.citizenRegistry.search(recInfo.idStr, obj.person);
     // Insert the person information in the registry only if he isn't already in
-    if (!personPtr) db.citizenRegistry.insert(recInfo.idStr, obj.person);
+    db.citizenRegistry.insert(obj.person);
 
     // Insert the new virus-country entry if its NOT already stored
     VirusCountryEntry *entryPtr;
@@ -315,29 +360,136 @@ void importFileRecords(string file, recordInfo &recInfo, recordObject &obj, appD
     // << "Duplicate records:" << std::setw(8) << dupRecords << std::endl;
 }
 
-// Sends all BloomFilters of known viruses to the travelClient
-void sendBloomFilters(appDataBase &db, int sockfd, unsigned int bloomSize, unsigned int bufferSize) {
+// Sends the BloomFilters of known viruses to a travelClient, a layer at a time.
+// The first time a layer is sent the whole bitArray is sent, afterwards
+// only the words that changed since, if any did. Full layers don't change,
+// so usually only the last layer and any layers added since are sent.
+// The changes are those since the previous export, so a client that didn't
+// receive that export is sent every layer whole instead.
+// Returns true if any layer changed since the previous export.
+bool sendBloomFilters(appDataBase &db, Connection &client, bool whole) {
     string line;
-    char *buffer;
+    char *buffer, *encoded = NULL;
+    Virus *virusPtr;
+    RoaringBitmap bitmap;
+    unsigned int numViruses = db.virusList.getSize(), changedFilters = 0, encodedSize = 0, layers = 0;
+    bool exportChanged = false;
+    // Export every layer first, to tell how many of them have changed
+    // Changed words of each layer of each virus, or -1 for the whole bitArray
+    int **changed = new int *[numViruses];
+    char ***deltas = new char **[numViruses];
+    // The other filter types are sent once, whole, for all layers
+    bool *wholeFilter = new bool[numViruses];
+    XorFilter *xorFilters = new XorFilter[numViruses];
+    for (unsigned int virus = 0; virus < numViruses; virus++) {
+        virusPtr = db.virusList.getNode(virus);
+        // A new virus is sized for the records it was loaded with
+        virusPtr->fitBloom();
+        layers = virusPtr->getBloomLayers();
+        changed[virus] = new int[layers];
+        deltas[virus] = new char *[layers];
+        unsigned int changedLayers = 0;
+        for (unsigned int layer = 0; layer < layers; layer++) {
+            changed[virus][layer] = virusPtr->exportBloom(layer, deltas[virus][layer]);
+            if (changed[virus][layer]) exportChanged = true;
+            if (whole) changed[virus][layer] = -1;
+            if (changed[virus][layer]) changedLayers++;
+        }
+        wholeFilter[virus] = changedLayers && CLIENT_FILTER_TYPE != BLOOM_FILTER;
+        if (wholeFilter[virus] && CLIENT_FILTER_TYPE == XOR_FILTER && !virusPtr->exportXor(xorFilters[virus])) {
+            // The client may hold an xor filter, so all the layers are sent whole
+            for (unsigned int layer = 0; layer < layers; layer++) changed[virus][layer] = -1;
+            wholeFilter[virus] = false;
+            changedLayers = layers;
+        }
+        changedFilters += wholeFilter[virus] ? 1 : changedLayers;
+    }
+
     /* Inform the client of the completion with the following formatted message: */
-    /* [PID] [1/0](Success/Failure) [totalInc] [totalDup] [totalRecs] [totalViruses] */
+    /* [PID] [1/0](Success/Failure) [totalInc] [totalDup] [totalRecs] [changedFilters] */
     line.assign(toString(getpid()) + " ");
     line.append(toString(1) + " ");
     line.append(toString(totalInc) + " ");
     line.append(toString(totalDup) + " ");
     line.append(toString(totalRecs) + " ");
-    line.append(toString(db.virusList.getSize()));
-    sendPackets(sockfd, line.c_str(), line.length()+1, bufferSize);
-
-    // Send all the bloom filters to the server
-    for (unsigned int virus = 0; virus < db.virusList.getSize(); virus++) {
-        // 1: virusName
-        line.assign(db.virusList.getNode(virus)->getName());
-        sendPackets(sockfd, line.c_str(), line.length()+1, bufferSize);
-        // 2: bloomFilter bitArray
-        buffer = db.virusList.getNode(virus)->getBloom();
-        sendPackets(sockfd, buffer, bloomSize, bufferSize);
+    line.append(toString(changedFilters));
+    client.writeMessage(line.c_str(), line.length()+1);
+
+    // Send the changed bloom filters to the server
+    for (unsigned int virus = 0; virus < numViruses; virus++) {
+        virusPtr = db.virusList.getNode(virus);
+        layers = virusPtr->getBloomLayers();
+        // In xor mode, the static filter is sent in place of the bloom filter
+        if (wholeFilter[virus] && CLIENT_FILTER_TYPE == XOR_FILTER) {
+            XorFilter &xorFilter = xorFilters[virus];
+            line.assign(virusPtr->getName());
+            client.writeMessage(line.c_str(), line.length()+1);
+            line.assign(toString(xorFilter.getBytes()) + " " + toString(XOR_HASHES) + " 0 0 ");
+            line.append(toString(XOR_FILTER) + " 0 " + toString(virusPtr->getID()));
+            client.writeMessage(line.c_str(), line.length()+1);
+            buffer = new char[xorFilter.getBytes()];
+            xorFilter.serialize(buffer);
+            client.writeMessage(buffer, xorFilter.getBytes());
+            delete[] buffer;
+            layers = 0;
+        }
+        // Same for the roaring bitmap, in roaring mode
+        if (wholeFilter[virus] && CLIENT_FILTER_TYPE == ROARING_FILTER) {
+            virusPtr->exportRoaring(bitmap);
+            line.assign(virusPtr->getName());
+            client.writeMessage(line.c_str(), line.length()+1);
+            line.assign(toString(bitmap.getBytes()) + " 0 0 0 " + toString(ROARING_FILTER) + " 0 ");
+            line.append(toString(virusPtr->getID()));
+            client.writeMessage(line.c_str(), line.length()+1);
+            buffer = new char[bitmap.getBytes()];
+            bitmap.serialize(buffer);
+            client.writeMessage(buffer, bitmap.getBytes());
+            delete[] buffer;
+            layers = 0;
+        }
+        // Otherwise, the bloom filter layers that changed
+        for (unsigned int layer = 0; layer < layers; layer++) {
+            if (!changed[virus][layer]) continue;
+            buffer = virusPtr->getBloom(layer);
+            // Try to encode the whole bitArray
+            encodedSize = 0;
+            if (BLOOM_WIRE_ENCODING && changed[virus][layer] < 0) {
+                encoded = new char[virusPtr->getBloomBytes(layer)];
+                encodedSize = bloomEncode(buffer, virusPtr->getBloomBytes(layer), encoded);
+            }
+            // 1: virusName
+            line.assign(virusPtr->getName());
+            client.writeMessage(line.c_str(), line.length()+1);
+            // 2: bloomFilter size in bytes, number of hash functions,
+            //    number of deltas, which is 0 for the whole bitArray,
+            //    size of the encoded bitArray, which is 0 if it's raw,
+            //    type of filter (BLOOM_FILTER, XOR_FILTER or ROARING_FILTER),
+            //    the layer it is, counting from 0, and the id of the virus
+            line.assign(toString(virusPtr->getBloomBytes(layer)) + " " + toString(virusPtr->getBloomFunctions(layer)));
+            line.append(" " + toString(changed[virus][layer] < 0 ? 0 : changed[virus][layer]));
+            line.append(" " + toString(encodedSize) + " " + toString(BLOOM_FILTER) + " " + toString(layer));
+            line.append(" " + toString(virusPtr->getID()));
+            client.writeMessage(line.c_str(), line.length()+1);
+            // 3: bloomFilter bitArray (raw or encoded) or its deltas
+            if (encodedSize) {
+                client.writeMessage(encoded, encodedSize);
+            } else if (changed[virus][layer] < 0) {
+                client.writeMessage(buffer, virusPtr->getBloomBytes(layer));
+            } else {
+                client.writeMessage(deltas[virus][layer], changed[virus][layer] * BLOOM_DELTA_SIZE);
+            }
+            delete[] encoded;
+            encoded = NULL;
+        }
+        for (unsigned int layer = 0; layer < virusPtr->getBloomLayers(); layer++) delete[] deltas[virus][layer];
+        delete[] changed[virus];
+        delete[] deltas[virus];
     }
+    delete[] changed;
+    delete[] deltas;
+    delete[] wholeFilter;
+    delete[] xorFilters;
+    return exportChanged;
 }
 
 // ==================== Threads ====================
@@ -349,7 +501,7 @@ void place(string file, circularBuffer &cBuffer) {
     pthread_mutex_lock(&cBuffer.bufLock);
     while (cBuffer.cBufNodes.full())
         pthread_cond_wait(&cBuffer.condNonFull, &cBuffer.bufLock);
-    cBuffer.cBufNodes.enqueue(file);
+    cBuffer.cBufNodes.enqueue(std::move(file));
     // std::cout << "Placed " << file << " in cyclic buffer\n";
     pthread_mutex_unlock(&cBuffer.bufLock);
 }
@@ -401,6 +553,260 @@ void *consumer(void *arg) {
     pthread_exit(EXIT_SUCCESS);
 }
 
+// ==================== Clients ====================
+// A pool of threads serves the travelClients, one at a time each, so that
+// as many clients as threads are served at the same time. Queries only read
+// the database and run in parallel, updates have the database to themselves.
+
+struct serverInfo {
+    appDataBase *dbPtr;
+    prodInfo *prodPtr;
+    consInfo *consPtr;
+    List<string> *folders, *fileList;
+    unsigned int numThreads, bufferSize, bloomSize;
+    int sock;  // Listening for clients
+    // Taken for reading by queries and for writing by updates and exports
+    pthread_rwlock_t dbLock;
+    // Guards the rest of the fields
+    pthread_mutex_t infoLock;
+    unsigned int acceptedReqs, rejectedReqs;
+    // Clients being served, and served so far
+    unsigned int active, served;
+    // Number of exports that changed the bloom filters
+    unsigned int generation;
+    serverInfo(appDataBase *a, prodInfo *p, consInfo *c, List<string> *fo, List<string> *fi,
+               unsigned int threads, unsigned int bufSize, unsigned int bSize, int s)
+    : dbPtr(a), prodPtr(p), consPtr(c), folders(fo), fileList(fi), numThreads(threads),
+    bufferSize(bufSize), bloomSize(bSize), sock(s), dbLock(PTHREAD_RWLOCK_INITIALIZER),
+    infoLock(PTHREAD_MUTEX_INITIALIZER), acceptedReqs(0), rejectedReqs(0), active(0),
+    served(0), generation(0) {}
+    ~serverInfo() {
+        pthread_rwlock_destroy(&dbLock);
+        pthread_mutex_destroy(&infoLock);
+    }
+};
+
+// Loads the given new files with numThreads consumers, holding the write lock
+void loadFiles(serverInfo *info, List<string> &newFileList) {
+    pthread_t pool_t[info->numThreads];
+    info->prodPtr->fileList = newFileList;
+    // Start threads to update the database
+    for (unsigned int t = 0; t < info->numThreads; t++)
+        if (pthread_create(&pool_t[t], NULL, consumer, info->consPtr))
+            die("pthread_create", -10);
+
+    // Call the producer function after we create the consumers,
+    // as this thread will be busy while producing information.
+    producer(info->prodPtr);
+
+    // Wait for all consumers to finish
+    for (unsigned int t = 0; t < info->numThreads; t++)
+        if (pthread_join(pool_t[t], NULL))
+            die("monitor/pthread_join", -11);
+
+    // Update the fileList
+    for (unsigned int file = 0; file < newFileList.getSize(); file++)
+        info->fileList->insertAscending(*newFileList.getNode(file));
+}
+
+// Exports the bloom filters and sends them to a client, which is
+// up to date with the given generation of them, holding the write lock
+void syncBloomFilters(serverInfo *info, Connection &client, unsigned int &generation) {
+    if (sendBloomFilters(*info->dbPtr, client, generation != info->generation)) info->generation++;
+    generation = info->generation;
+}
+
+// Answers the queries of a client until it exits
+void serveClient(serverInfo *info, Connection &client) {
+    appDataBase &db = *info->dbPtr;
+    List<string> tempList, newFileList;
+    string reply;
+    char *message = NULL;
+    unsigned int size = 0;
+    uint32_t date = 0;
+    // The generation of the bloom filters the client holds
+    unsigned int generation = 0;
+    // Buffers of this client's queries
+    recordObject obj(info->bloomSize);
+    queryHeader header;
+    travelQuery request;
+    travelResult result;
+    travelAnswer answer;
+    statusQuery status;
+    statusAnswer statusReply;
+
+    // Pointers to handle all the structures and objects
+    Virus *virusPtr;
+    Person *personPtr;
+    Record *recordPtr;
+
+    // Variables for menu options
+    int option = -1;
+
+    // Reply to the travelClient
+    pthread_rwlock_wrlock(&info->dbLock);
+    syncBloomFilters(info, client, generation);
+    pthread_rwlock_unlock(&info->dbLock);
+
+    do {
+
+        // Read the query and tell its type. A client that went away
+        // without exiting ends only its own session.
+        if (!(message = client.readMessage())) {
+            std::cerr << CLIENT_LOST(getpid());
+            break;
+        }
+        size = client.getMessageSize();
+        option = messageOpcode(message, size);
+
+        switch (option) {
+
+            case QUERY_TRAVEL_RESULT:
+
+                if (!decodeMessage(message, size, result)) break;
+                pthread_mutex_lock(&info->infoLock);
+                result.accepted ? info->acceptedReqs++ : info->rejectedReqs++;
+                pthread_mutex_unlock(&info->infoLock);
+                break;
+
+            case QUERY_TRAVEL_REQUEST:
+
+                if (!decodeMessage(message, size, request)) break;
+                memset(&answer, 0, sizeof(answer));
+                answer.opcode = ANSWER_TRAVEL_REQUEST;
+                // Sent back, so that the client can tell which request this answers
+                answer.requestID = request.requestID;
+                obj.record.setID(ntohl(request.citizenID));
+                pthread_rwlock_rdlock(&info->dbLock);
+                virusPtr = db.searchVirus(ntohs(request.virusID));
+                if (virusPtr) {
+                    recordPtr = virusPtr->searchVaccinatedList(obj.record);
+                    if (recordPtr) {
+                        answer.vaccinated = 1;
+                        answer.date = htonl(recordPtr->packedDate());
+                    }
+                }
+                pthread_rwlock_unlock(&info->dbLock);
+                client.writeMessage((const char *)&answer, sizeof(answer));
+                break;
+
+            case QUERY_ADD_RECORDS:
+
+                pthread_rwlock_wrlock(&info->dbLock);
+                initFileList(*info->folders, tempList);
+                // Keep only the new files
+                for (unsigned int file = 0; file < tempList.getSize(); file++)
+                    if (!info->fileList->search(*tempList.getNode(file)))
+                        newFileList.insertAscending(*tempList.getNode(file));
+
+                // A client that missed the updates of other clients is sent them as well
+                header.opcode = (newFileList.empty() && generation == info->generation) ? ANSWER_NOT_FOUND : ANSWER_UPDATE;
+                client.writeMessage((const char *)&header, sizeof(header));
+                if (header.opcode == ANSWER_NOT_FOUND) {
+                    pthread_rwlock_unlock(&info->dbLock);
+                    break;
+                }
+
+                if (!newFileList.empty()) loadFiles(info, newFileList);
+
+                // Reply to the travelClient
+                syncBloomFilters(info, client, generation);
+                pthread_rwlock_unlock(&info->dbLock);
+                newFileList.flush();
+                break;
+
+            case QUERY_SEARCH_STATUS:
+
+                if (!decodeMessage(message, size, status)) break;
+                memset(&statusReply, 0, sizeof(statusReply));
+                statusReply.opcode = ANSWER_SEARCH_STATUS;
+                statusReply.citizenID = status.citizenID;
+                pthread_rwlock_rdlock(&info->dbLock);
+                personPtr = db.citizenRegistry.search(ntohl(status.citizenID));
+                if (!personPtr) {
+                    pthread_rwlock_unlock(&info->dbLock);
+                    client.writeMessage((const char *)&statusReply, sizeof(statusReply));
+                    break;
+                }
+
+                // Reply format: [statusAnswer] [DATES] [FIRST NAME] [LAST NAME] [COUNTRY] [VIRUS NAMES]
+                statusReply.found = 1;
+                statusReply.numViruses = htons(db.virusList.getSize());
+                statusReply.age = htonl(personPtr->getAge());
+                reply.assign((const char *)&statusReply, sizeof(statusReply));
+
+                obj.record.setID(personPtr->ID());
+
+                for (unsigned int virus = 0; virus < db.virusList.getSize(); virus++) {
+                    virusPtr = db.virusList.getNode(virus);
+                    recordPtr = NULL;
+                    if (virusPtr->checkBloom(personPtr->ID()))
+                        recordPtr = virusPtr->searchVaccinatedList(obj.record);
+                    date = htonl(recordPtr ? recordPtr->packedDate() : 0);
+                    reply.append((const char *)&date, sizeof(date));
+                }
+                reply.append(personPtr->getFirstName() + '\0');
+                reply.append(personPtr->getLastName() + '\0');
+                reply.append(personPtr->getCountry().getName() + '\0');
+                for (unsigned int virus = 0; virus < db.virusList.getSize(); virus++)
+                    reply.append(db.virusList.getNode(virus)->getName() + '\0');
+                pthread_rwlock_unlock(&info->dbLock);
+
+                client.writeMessage(reply.data(), reply.length());
+                break;
+
+            case QUERY_SHUTDOWN:
+
+                // Accepting ends, the clients being served stay until they exit
+                stopListening(info->sock);
+                break;
+
+            default:
+                break;
+        }
+    } while (option != QUERY_EXIT && option != QUERY_SHUTDOWN);
+
+    client.flush();
+}
+
+// Serves the clients that connect, one at a time, until the listening socket
+// is shut down by a QUERY_SHUTDOWN. The monitor then stops once every client
+// it's still serving has exited.
+void *clientWorker(void *arg) {
+    serverInfo *info = (serverInfo *)arg;
+    struct sockaddr_in travel = {'\0'};
+    socklen_t travelLen = sizeof(travel);
+    char hostName[NI_MAXHOST];
+    int newsock = 0;
+
+    while ((newsock = acceptConnection(info->sock, (struct sockaddr *)&travel, &travelLen)) >= 0) {
+        pthread_mutex_lock(&info->infoLock);
+        info->active++;
+        info->served++;
+        pthread_mutex_unlock(&info->infoLock);
+
+        // gethostbyaddr isn't safe to call from many threads
+        if (getnameinfo((struct sockaddr *)&travel, travelLen, hostName, sizeof(hostName), NULL, 0, 0)) {
+            std::cerr << "monitor/getnameinfo: can't resolve the client's address\n";
+            exit(-4);
+        }
+        std::cout << ACCEPTED_CONN(getpid(), hostName);
+
+        {
+            // Messages are read into a buffer of socketBufferSize bytes at first
+            Connection client(newsock, info->bufferSize);
+            serveClient(info, client);
+        }
+        closeSocket(newsock);
+        travelLen = sizeof(travel);
+
+        pthread_mutex_lock(&info->infoLock);
+        info->active--;
+        pthread_mutex_unlock(&info->infoLock);
+    }
+    pthread_exit(EXIT_SUCCESS);
+}
+
 int main(int argc, char *argv[]) {
 
     // =========== Input Arguments Validation ===========
@@ -411,24 +817,17 @@ int main(int argc, char *argv[]) {
     // ========== Variables ==========
 
     /* Regular variables */
-    int sock = 0, newsock = 0;
+    int sock = 0;
     uint16_t port = myStoi(argv[2]);
     unsigned int numThreads = myStoi(argv[4]);
     unsigned int bufferSize = myStoi(argv[6]);
     unsigned int cBufferSize = myStoi(argv[8]);
     unsigned int bloomSize = myStoi(argv[10]);
-    unsigned int acceptedReqs = 0, rejectedReqs = 0;
-    string line;
-    char *buffer = NULL;
-    bool request = false;
-    List<string> folders, fileList, newFileList, tempList;
+    List<string> folders, fileList, tempList;
 
     /* Networking variables */
-    struct sockaddr_in monitor = {'\0'}, travel = {'\0'};
-    socklen_t travelLen = sizeof(travel);
+    struct sockaddr_in monitor = {'\0'};
     struct sockaddr *monitorPtr = (struct sockaddr *)&monitor;
-    struct sockaddr *travelPtr = (struct sockaddr *)&travel;
-    struct hostent *remHost;
 
     /* Database structs */
     // Keeps all necessary info for a record
@@ -489,159 +888,32 @@ int main(int argc, char *argv[]) {
     listenConnections(sock, MAX_CONNECTIONS);
     std::cout << LISTENING_TO(getpid(), port);
 
-    newsock = acceptConnection(sock, travelPtr, &travelLen);
-    if ((remHost = gethostbyaddr((const void *)&travel.sin_addr,
-        sizeof(travel.sin_addr), travel.sin_family)) == NULL) {
-        herror("monitor/gethostbyaddr");
-        exit(-4);
-    }
-    std::cout << ACCEPTED_CONN(getpid(), remHost->h_name);
-
-    // Reply to the travelClient
-    sendBloomFilters(db, newsock, bloomSize, bufferSize);
-
     // ========== Communication installation END ==========
 
-    // Pointers to handle all the structures and objects
-    Virus *virusPtr;
-    Person *personPtr;
-    Record *recordPtr;
-
-    // Variables for menu options
-    string command;
-    int option = -1;
-
     // ========== Main application - Queries ==========
 
-    do {
-
-        option = -1;
-        // Read and parse the command
-        buffer = receivePackets(newsock, bufferSize);
-        line.assign(buffer);
-        delete[] buffer;
-        splitLine(line, args);
-        if (isInt(args.getFirst())) {
-            option = myStoi(args.getFirst());
-            args.popFirst();
-        }
-
-        switch (option) {
-
-            case travelRequest:
-
-                if (args.getFirst().compare(REQUEST)) {
-                    // This is an update message from client, either ["ACCEPTED"] or ["REJECTED"]
-                    !args.getFirst().compare(ACCEPTED) ? acceptedReqs++ : rejectedReqs++;
-                } else {
-                    // This is a request from client in format ["REQUEST"] [citizenID] [virus]
-                    args.popFirst();
-                    recInfo.idStr.assign(args.getFirst());
-                    obj.record.setID(myStoi(recInfo.idStr));
-                    recInfo.virusName.assign(args.getLast());
-                    obj.virus.setName(recInfo.virusName);
-                    virusPtr = db.virusList.search(obj.virus);
-                    if (virusPtr) {
-                        recordPtr = virusPtr->searchVaccinatedList(obj.record);
-                        if (recordPtr) {
-                            request = true;
-                            obj.date1 = recordPtr->getDate();
-                        }
-                    }
-                    // Send the result to the back travelClient
-                    request ? line.assign("YES " + toString(obj.date1)) : line.assign("NO");
-                    sendPackets(newsock, line.c_str(), line.length()+1, bufferSize);
-                }
-                break;
-
-            case travelStats:
-                // Nothing to do here
-                break;
-
-            case addRecords:
-
-                initFileList(folders, tempList);
-                // Keep only the new files
-                for (unsigned int file = 0; file < tempList.getSize(); file++)
-                    if (!fileList.search(*tempList.getNode(file)))
-                        newFileList.insertAscending(*tempList.getNode(file));
-
-                if (newFileList.empty()) {
-                    sendPackets(newsock, NOT_FOUND, sizeof(NOT_FOUND), bufferSize);
-                    break;
-                } else sendPackets(newsock, UPDATE, sizeof(UPDATE), bufferSize);
-
-                prodArgs.fileList = newFileList;
-                // Start threads to update the database
-                for (unsigned int t = 0; t < numThreads; t++)
-                    if (pthread_create(&pool_t[t], NULL, consumer, &consArgs))
-                        die("pthread_create", -10);
-
-                // Call the producer function after we create the consumers,
-                // as the main thread will be busy while producing information.
-                producer(&prodArgs);
-
-                // Wait for all consumers to finish
-                for (unsigned int t = 0; t < numThreads; t++)
-                    if (pthread_join(pool_t[t], NULL))
-                        die("monitor/pthread_join", -11);
-
-                // Reply to the travelClient
-                sendBloomFilters(db, newsock, bloomSize, bufferSize);
-
-                // Update the fileList
-                for (unsigned int file = 0; file < newFileList.getSize(); file++)
-                    fileList.insertAscending(*newFileList.getNode(file));
-                newFileList.flush();
-                break;
-
-            case searchStatus:
-
-                obj.person.setID(myStoi(args.getFirst()));
-                personPtr = db.citizenRegistry.search(args.getFirst(), obj.person);
-                if (!personPtr) {
-                    line.assign(NOT_FOUND);
-                    sendPackets(newsock, line.c_str(), line.length()+1, bufferSize);
-                    break;
-                }
-
-                // Reply format: [ID] [NAME] [SURNAME] [COUNTRY] [AGE] [VACCINATION-LIST]
-                line.assign(args.getFirst() + " " +
-                            personPtr->getFirstName() + " " +
-                            personPtr->getLastName() + " " +
-                            personPtr->getCountry().getName() + " " +
-                            toString(personPtr->getAge()));
-
-                obj.record.setID(personPtr->ID());
-
-                for (unsigned int virus = 0; virus < db.virusList.getSize(); virus++) {
-                    virusPtr = db.virusList.getNode(virus);
-                    line.append(" " + virusPtr->getName() + " ");
-                    recordPtr = NULL;
-                    if (virusPtr->checkBloom(args.getFirst()))
-                        recordPtr = virusPtr->searchVaccinatedList(obj.record);
-                    recordPtr ? line.append(recordPtr->getDate()) : line.append("NO");
-                }
-
-                sendPackets(newsock, line.c_str(), line.length()+1, bufferSize);
-                break;
+    // Serve the clients with numThread workers
+    serverInfo info(&db, &prodArgs, &consArgs, &folders, &fileList, numThreads, bufferSize, bloomSize, sock);
+    for (unsigned int t = 0; t < numThreads; t++)
+        if (pthread_create(&pool_t[t], NULL, clientWorker, &info))
+            die("pthread_create", -10);
 
-            default:
-                break;
-        }
-    } while (option);
+    // Wait until the monitor is shut down and its clients have exited
+    for (unsigned int t = 0; t < numThreads; t++)
+        if (pthread_join(pool_t[t], NULL))
+            die("monitor/pthread_join", -11);
 
     tempList.flush();
+    // Countries are already sorted by name
     for (unsigned int i = 0; i < db.countryList.getSize(); i++)
-        tempList.insertAscending(db.countryList.getNode(i)->getName());
+        tempList.insertLast(db.countryList.getNode(i)->getName());
 
     // Save the request statistics in log files
-    writeLogFile(tempList, toString(LOGS_PATH), PERMS, acceptedReqs, rejectedReqs);
+    writeLogFile(tempList, toString(LOGS_PATH), PERMS, info.acceptedReqs, info.rejectedReqs);
 
     std::cout << MONITOR_STOPPED(getpid());
 
     closeSocket(sock);
-    closeSocket(newsock);
 
     return EXIT_SUCCESS;
 
@@ -4,16 +4,20 @@ MonitorInfo::MonitorInfo(const MonitorInfo &monitor) {
     if (this == &monitor) return;
     pid = monitor.PID();
     sock = monitor.getSocket();
+    connection = monitor.getConnection();
     server = monitor.server;
     countries = monitor.countries;
+    pending = monitor.pending;
 }
 
 MonitorInfo &MonitorInfo::operator=(const MonitorInfo &monitor) {
     if (this == &monitor) return *this;
     pid = monitor.PID();
     sock = monitor.getSocket();
+    connection = monitor.getConnection();
     server = monitor.server;
     countries = monitor.countries;
+    pending = monitor.pending;
     return *this;
 }
 
@@ -1,19 +1,192 @@
+#include <cmath>
+#include <utility>
+
 #include "include/VirusRegistry.hpp"
+#include "../../include/BloomDelta.hpp"
+#include "../../include/BloomEncoding.hpp"
+#include "../../include/DataManipulationLib.hpp"
 
-VirusRegistry::VirusRegistry(const VirusRegistry &vRegistry) {
-    if (this == &vRegistry) return;
-    name.clear();
-    name.assign(vRegistry.getName());
-}
+VirusRegistry::VirusRegistry(const VirusRegistry &vRegistry)
+    : name(vRegistry.name), filters(vRegistry.filters),
+      bloomChecks(vRegistry.bloomChecks), bloomHits(vRegistry.bloomHits),
+      confirmedHits(vRegistry.confirmedHits), falsePositives(vRegistry.falsePositives) {}
+
+VirusRegistry::VirusRegistry(VirusRegistry &&vRegistry)
+    : name(std::move(vRegistry.name)), filters(std::move(vRegistry.filters)),
+      bloomChecks(vRegistry.bloomChecks), bloomHits(vRegistry.bloomHits),
+      confirmedHits(vRegistry.confirmedHits), falsePositives(vRegistry.falsePositives) {}
 
 VirusRegistry &VirusRegistry::operator=(const VirusRegistry &vRegistry) {
     if (this == &vRegistry) return *this;
     name.clear();
     name.assign(vRegistry.getName());
-    filter = vRegistry.filter;
+    filters = vRegistry.filters;
+    bloomChecks = vRegistry.bloomChecks;
+    bloomHits = vRegistry.bloomHits;
+    confirmedHits = vRegistry.confirmedHits;
+    falsePositives = vRegistry.falsePositives;
     return *this;
 }
 
+VirusRegistry &VirusRegistry::operator=(VirusRegistry &&vRegistry) {
+    if (this == &vRegistry) return *this;
+    name = std::move(vRegistry.name);
+    filters = std::move(vRegistry.filters);
+    bloomChecks = vRegistry.bloomChecks;
+    bloomHits = vRegistry.bloomHits;
+    confirmedHits = vRegistry.confirmedHits;
+    falsePositives = vRegistry.falsePositives;
+    return *this;
+}
+
+sourceFilter *VirusRegistry::findSource(int source) {
+    for (unsigned int pos = 0; pos < filters.getSize(); pos++)
+        if (filters.getNode(pos)->source == source) return filters.getNode(pos);
+    return NULL;
+}
+
+sourceFilter *VirusRegistry::addSource(int source) {
+    sourceFilter *src = findSource(source);
+    if (!src) {
+        // Its bloom filter has no layers, until it's used
+        filters.emplaceLast(source);
+        src = &filters.getLast();
+    }
+    return src;
+}
+
+int VirusRegistry::getVirusID(int source) {
+    sourceFilter *src = findSource(source);
+    return src ? src->virusID : -1;
+}
+
+VirusFilter *VirusRegistry::prepareLayer(int source, unsigned int layer, unsigned int bytes, unsigned int functions) {
+    // A layer this build's filter can't probe the same way is rejected
+    if (!VirusFilter::validFunctions(functions)) return NULL;
+    sourceFilter *src = addSource(source);
+    if (!layer) src->filter.truncate(1);
+    return src->filter.setLayer(layer, bytes, functions);
+}
+
+bool VirusRegistry::setBloom(int source, unsigned int layer, const char *array,
+                             unsigned int bytes, unsigned int functions) {
+    VirusFilter *filter = prepareLayer(source, layer, bytes, functions);
+    if (!filter) return false;
+    filter->init(array, bytes);
+    findSource(source)->type = BLOOM_FILTER;
+    return true;
+}
+
+bool VirusRegistry::setXorFilter(int source, const char *array, unsigned int size) {
+    sourceFilter *src = addSource(source);
+    if (!src->xorFilter.load(array, size)) return false;
+    src->type = XOR_FILTER;
+    return true;
+}
+
+bool VirusRegistry::setRoaringBitmap(int source, const char *array, unsigned int size) {
+    sourceFilter *src = addSource(source);
+    if (!src->bitmap.load(array, size)) {
+        // Don't check a partially loaded bitmap
+        src->bitmap.flush();
+        return false;
+    }
+    src->type = ROARING_FILTER;
+    return true;
+}
+
+bool VirusRegistry::setEncodedBloom(int source, unsigned int layer, const char *encoded, unsigned int size,
+                                    unsigned int bytes, unsigned int functions) {
+    VirusFilter *filter = prepareLayer(source, layer, bytes, functions);
+    // Decode straight into the layer
+    if (!filter || filter->getSize() != bytes * BITS_IN_BYTE) return false;
+    findSource(source)->type = BLOOM_FILTER;
+    return bloomDecode(encoded, size, filter->getArray(), bytes);
+}
+
+bool VirusRegistry::patchBloom(int source, unsigned int layer, const char *deltas,
+                               unsigned int count, unsigned int bytes) {
+    sourceFilter *src = findSource(source);
+    if (!src || src->type != BLOOM_FILTER) return false;
+    VirusFilter *filter = src->filter.getLayer(layer);
+    if (!filter || filter->getSize() != bytes * BITS_IN_BYTE) return false;
+    bloomPatch(filter->getArray(), bytes, deltas, count);
+    return true;
+}
+
+void VirusRegistry::checkBloom(int source, const unsigned int *ids, unsigned int n, bool *out) {
+    bloomChecks += n;
+    // A monitor that never sent a filter has no records of the virus
+    sourceFilter *src = findSource(source);
+    if (src && src->type == BLOOM_FILTER)
+        src->filter.checkMany(ids, n, out);
+    else {
+        // The other filters have no batched lookup
+        for (unsigned int i = 0; i < n; i++)
+            out[i] = src && ((src->type == XOR_FILTER && src->xorFilter.check(ids[i])) ||
+                             (src->type == ROARING_FILTER && src->bitmap.check(ids[i])));
+    }
+    for (unsigned int i = 0; i < n; i++)
+        if (out[i]) bloomHits++;
+}
+
+double VirusRegistry::fillRatio() {
+    double setBits = 0, bits = 0;
+    for (unsigned int pos = 0; pos < filters.getSize(); pos++) {
+        sourceFilter *src = filters.getNode(pos);
+        if (src->type != BLOOM_FILTER) continue;
+        for (unsigned int layer = 0; layer < src->filter.getLayers(); layer++) {
+            VirusFilter *filter = src->filter.getLayer(layer);
+            setBits += filter->fillRatio() * filter->getSize();
+            bits += filter->getSize();
+        }
+    }
+    return bits ? setBits / bits : 0.0;
+}
+
+double VirusRegistry::theoreticalFPR() {
+    // A citizen is only checked against the filter of one monitor, so this
+    // is the mean of their rates. A citizen passes if any layer lets them through.
+    double sum = 0.0;
+    for (unsigned int pos = 0; pos < filters.getSize(); pos++) {
+        sourceFilter *src = filters.getNode(pos);
+        double pass = 1.0;
+        if (src->type == BLOOM_FILTER) {
+            for (unsigned int layer = 0; layer < src->filter.getLayers(); layer++) {
+                VirusFilter *filter = src->filter.getLayer(layer);
+                pass *= 1.0 - pow(filter->fillRatio(), filter->getFunctionsNumber());
+            }
+        } else if (src->type == XOR_FILTER)
+            pass *= 1.0 - 1.0 / 256;  // One in 2^8 fingerprints matches
+        // Roaring bitmaps are exact
+        sum += 1.0 - pass;
+    }
+    return filters.empty() ? 0.0 : sum / filters.getSize();
+}
+
+double VirusRegistry::observedFPR() const {
+    // Citizens rejected by the filters were certainly not vaccinated
+    unsigned int negatives = (bloomChecks - bloomHits) + falsePositives;
+    return negatives ? (double)falsePositives / negatives : 0.0;
+}
+
+std::string VirusRegistry::bloomStats() {
+    return name + " CHECKS " + toString(bloomChecks) + " HITS " + toString(bloomHits) +
+           " CONFIRMED " + toString(confirmedHits) + " FALSE POSITIVES " + toString(falsePositives) +
+           " OBSERVED FPR " + toString(observedFPR()) + " FILL RATIO " + toString(fillRatio()) +
+           " THEORETICAL FPR " + toString(theoreticalFPR()) + '\n';
+}
+
+void VirusRegistry::bloomStatus() {
+    for (unsigned int pos = 0; pos < filters.getSize(); pos++) {
+        sourceFilter *src = filters.getNode(pos);
+        for (unsigned int layer = 0; layer < src->filter.getLayers(); layer++) {
+            std::cout << src->source << "/" << layer << ": ";
+            src->filter.getLayer(layer)->arrayStatus();
+        }
+    }
+}
+
 bool operator==(const VirusRegistry &v1, const VirusRegistry &v2) {
     return (v1.getName() == v2.getName());
 }
@@ -0,0 +1,30 @@
+#ifndef BATCHEDREQUEST_HPP
+#define BATCHEDREQUEST_HPP
+
+#include "MonitorInfo.hpp"
+#include "PendingRequest.hpp"
+
+// A travelRequest whose citizen waits to be checked against the filter along
+// with those of the next requests, before it is promoted to its monitor
+class BatchedRequest {
+   private:
+    PendingRequest pending;
+    MonitorInfo *monitor;  // That keeps the records of the citizen's country
+    unsigned int citizenID;
+
+   public:
+    BatchedRequest(const PendingRequest &p = PendingRequest(), MonitorInfo *m = NULL, unsigned int c = 0)
+    : pending(p), monitor(m), citizenID(c) {}
+    ~BatchedRequest() {}
+
+    PendingRequest &getPending() { return pending; }
+    MonitorInfo *getMonitor() const { return monitor; }
+    unsigned int getCitizenID() const { return citizenID; }
+
+    friend bool operator==(const BatchedRequest &b1, const BatchedRequest &b2) {
+        return b1.pending.getID() == b2.pending.getID();
+    }
+    friend bool operator!=(const BatchedRequest &b1, const BatchedRequest &b2) { return !(b1 == b2); }
+};
+
+#endif
\ No newline at end of file
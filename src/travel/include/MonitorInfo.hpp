@@ -1,6 +1,8 @@
 #ifndef MONITORINFO_HPP
 #define MONITORINFO_HPP
 
+#define PIPELINE_DEPTH 64  // travelRequests that may wait for the answer of a monitor
+
 #include <cstring>
 #include <netdb.h>
 #include <sys/socket.h>
@@ -8,24 +10,30 @@
 #include <iostream>
 
 #include "../../../include/AppStandards.hpp"
+#include "../../../include/Connection.hpp"
 #include "../../../include/List.hpp"
+#include "PendingRequest.hpp"
 
 class MonitorInfo {
 private:
     pid_t pid;
     int sock;
+    Connection *connection;  // Of the socket, shared by the copies of this object
     sockaddr_in server;
     List<std::string> countries;
+    // Promoted travelRequests that haven't been answered yet
+    List<PendingRequest> pending;
 
 public:
     MonitorInfo(pid_t p = 0, sa_family_t family = AF_INET, uint32_t addr = htonl(INADDR_ANY))
-    : pid(p) { server.sin_family = family; server.sin_addr.s_addr = htonl(addr); }
+    : pid(p), connection(NULL) { server.sin_family = family; server.sin_addr.s_addr = htonl(addr); }
     ~MonitorInfo() { countries.flush(); }
     MonitorInfo(const MonitorInfo &monitor);
     MonitorInfo &operator=(const MonitorInfo &monitor);
 
     int PID () const { return pid; }
     int getSocket() const { return sock; }
+    Connection *getConnection() const { return connection; }
     socklen_t getSockLen() { return sizeof(server); }
     uint16_t getPort() const { return ntohs(server.sin_port); }
     sockaddr_in &getServer() { return server; }
@@ -37,9 +45,11 @@ public:
         return *countries.getNode(pos);
     }
     unsigned int countriesNumber() { return countries.getSize(); }
+    List<PendingRequest> &getPending() { return pending; }
 
     void setPID(unsigned int p) { pid = p; }
     void setSocket(int s) { sock = s; }
+    void setConnection(Connection *c) { connection = c; }
     void setFamily(sa_family_t family = AF_INET) { server.sin_family = family; }
     void setAddress(uint32_t addr = ntohl(INADDR_ANY)) { server.sin_addr.s_addr = addr; }
     void setAddress(hostent *remHost) { memcpy(&server.sin_addr, remHost->h_addr, remHost->h_length); }
@@ -0,0 +1,29 @@
+#ifndef PENDINGREQUEST_HPP
+#define PENDINGREQUEST_HPP
+
+#include <iostream>
+
+#include "Request.hpp"
+
+// A travelRequest that was promoted to a monitor and waits for its answer,
+// which carries the same id, since a monitor may answer in any order
+class PendingRequest {
+   private:
+    unsigned int id;
+    Request request;
+    std::string countryTo;
+
+   public:
+    PendingRequest(unsigned int i = 0) : id(i) {}
+    PendingRequest(unsigned int i, const Request &r, std::string c) : id(i), request(r), countryTo(c) {}
+    ~PendingRequest() {}
+
+    unsigned int getID() const { return id; }
+    Request &getRequest() { return request; }
+    std::string getCountryTo() const { return countryTo; }
+
+    friend bool operator==(const PendingRequest &p1, const PendingRequest &p2) { return p1.id == p2.id; }
+    friend bool operator!=(const PendingRequest &p1, const PendingRequest &p2) { return p1.id != p2.id; }
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,25 @@
+#ifndef VERDICT_HPP
+#define VERDICT_HPP
+
+#include <cstddef>
+
+// The message that tells the user how a travelRequest went. Requests are
+// answered in any order, so their verdicts wait in the order of the commands
+// and each one is printed once every earlier one has been.
+class Verdict {
+   private:
+    unsigned int id;      // Of the request, as sent to its monitor
+    const char *message;  // NULL until the request is answered
+
+   public:
+    Verdict(unsigned int i = 0, const char *m = NULL) : id(i), message(m) {}
+    ~Verdict() {}
+
+    void setMessage(const char *m) { message = m; }
+    const char *getMessage() const { return message; }
+
+    friend bool operator==(const Verdict &v1, const Verdict &v2) { return v1.id == v2.id; }
+    friend bool operator!=(const Verdict &v1, const Verdict &v2) { return v1.id != v2.id; }
+};
+
+#endif
\ No newline at end of file
@@ -3,33 +3,100 @@
 
 #include <iostream>
 
-#include "../../../include/BloomFilter.hpp"
+#include "../../../include/AppStandards.hpp"
+#include "../../../include/List.hpp"
+#include "../../../include/RoaringBitmap.hpp"
+#include "../../../include/ScalableBloomFilter.hpp"
+#include "../../../include/VirusFilter.hpp"
+#include "../../../include/XorFilter.hpp"
+
+// The bloom filter a single monitor keeps for a virus, a copy of its layers.
+// Every monitor sizes its filters for its own records, so the
+// filters of different monitors can't be merged into one.
+// A monitor may send a static xor filter or an exact roaring
+// bitmap in place of its bloom filter.
+struct sourceFilter {
+    int source;   // PID of the monitor
+    int virusID;  // That the monitor interned the virus with (see QueryProtocol.hpp)
+    int type;     // Which of the filters is used (see CLIENT_FILTER_TYPE)
+    ScalableBloomFilter<VirusFilter> filter;
+    XorFilter xorFilter;
+    RoaringBitmap bitmap;
+
+    sourceFilter(int src = -1) : source(src), virusID(-1), type(BLOOM_FILTER) {}
+};
 
 class VirusRegistry {
    private:
     std::string name;
-    BloomFilter filter;
+    List<sourceFilter> filters;
+    // How the filters did in travelRequests: hits are the citizens that the
+    // filters let through, and every hit the monitor then answered NO for
+    // is a false positive. The rest of the hits are confirmed.
+    unsigned int bloomChecks;
+    unsigned int bloomHits;
+    unsigned int confirmedHits;
+    unsigned int falsePositives;
+
+    sourceFilter *findSource(int source);
+    // Returns the filter of monitor source, which is created if it's not found
+    sourceFilter *addSource(int source);
+    // Returns the given layer of the filter of monitor source, reset to the given
+    // geometry if needed. NULL if the layers before it haven't been received,
+    // or if VirusFilter can't use that many hash functions.
+    VirusFilter *prepareLayer(int source, unsigned int layer, unsigned int bytes, unsigned int functions);
 
    public:
-    VirusRegistry() : name("") {}
-    VirusRegistry(unsigned int bloomSize) : name(""), filter(bloomSize) {}
+    VirusRegistry()
+        : name(""), bloomChecks(0), bloomHits(0), confirmedHits(0), falsePositives(0) {}
     ~VirusRegistry() {}
     VirusRegistry(const VirusRegistry &vRegistry);
+    VirusRegistry(VirusRegistry &&vRegistry);
     VirusRegistry &operator=(const VirusRegistry &vRegistry);
+    VirusRegistry &operator=(VirusRegistry &&vRegistry);
 
     std::string getName() const { return name; }
-    unsigned int getBloomSize() const { return filter.getSize(); }
+    unsigned int getSourcesNumber() const { return filters.getSize(); }
 
     void setName(const std::string &str) { name = str; }
-    void initializeBloom(const VirusRegistry &vRegistry) { filter = vRegistry.filter; }
-    void initializeBloom(char *array, unsigned int size) { filter.merge(array, size); }
-    void copyBloom(BloomFilter &bloom) { bloom = filter; }
-    void insertBloom(const std::string &str) { filter.insert(str); }
-    void mergeBloom(char *array, unsigned int size) { filter.merge(array, size); }
+    // The id monitor source interned the virus with, or -1 if it never sent its filter
+    int getVirusID(int source);
+    void setVirusID(int source, unsigned int id) { addSource(source)->virusID = id; }
+    // Replaces a layer of the filter of monitor source with the given array,
+    // which holds a filter of bytes size and functions hash functions. The
+    // first layer is only sent whole by a new monitor, so the layers after
+    // it are dropped. False if the layers before it haven't been received.
+    bool setBloom(int source, unsigned int layer, const char *array, unsigned int bytes, unsigned int functions);
+    // Same as setBloom, for an array of length size that is run-length encoded
+    // (see BloomEncoding.hpp). False if the encoded array is malformed as well.
+    bool setEncodedBloom(int source, unsigned int layer, const char *encoded, unsigned int size,
+                         unsigned int bytes, unsigned int functions);
+    // Overwrites the changed words of a layer of the filter of monitor source with
+    // count deltas (see BloomDelta.hpp). False if that layer isn't bytes long.
+    bool patchBloom(int source, unsigned int layer, const char *deltas, unsigned int count, unsigned int bytes);
+
+    // Replaces the filter of monitor source with the serialized xor filter
+    // of given size. False if it's malformed.
+    bool setXorFilter(int source, const char *array, unsigned int size);
+    // Replaces the filter of monitor source with the serialized roaring bitmap
+    // of given size. False if it's malformed.
+    bool setRoaringBitmap(int source, const char *array, unsigned int size);
+
+    // Stores in out whether the filter of monitor source, the one that keeps the
+    // records of the citizens' country, may contain each of the n citizen ids
+    void checkBloom(int source, const unsigned int *ids, unsigned int n, bool *out);
+    // Records the answer of the monitor to a citizen that checkBloom let through
+    void registerAnswer(bool vaccinated) { vaccinated ? confirmedHits++ : falsePositives++; }
 
-    bool checkBloom(const std::string &str) { return filter.check(str); }
-    // Parameter size is for securing we're merging samesize filters
-    char *getBloom() const { return filter.getArray(); }
+    // Fraction of the bits set in the bloom filters of all monitors
+    double fillRatio();
+    // False positive rate that the filter of a monitor gives on average,
+    // estimated from their fill ratios (fill ^ k for each bloom filter layer)
+    double theoreticalFPR();
+    // False positives out of all the citizens that weren't vaccinated
+    double observedFPR() const;
+    // One line with all the above, as it's shown and written in the logs
+    std::string bloomStats();
 
     friend bool operator==(const VirusRegistry &v1, const VirusRegistry &v2);
     friend bool operator!=(const VirusRegistry &v1, const VirusRegistry &v2);
@@ -39,7 +106,7 @@ class VirusRegistry {
     friend bool operator>=(const VirusRegistry &v1, const VirusRegistry &v2);
     friend std::ostream &operator<<(std::ostream &os, const VirusRegistry &vRegistry);
 
-    void bloomStatus() const { filter.arrayStatus(); }
+    void bloomStatus();
     void print() const { std::cout << *this; };
 };
 
@@ -6,16 +6,21 @@
 
 #include "../../include/AppStandards.hpp"
 #include "../../include/BloomFilter.hpp"
+#include "../../include/Connection.hpp"
 #include "../../include/DataManipulationLib.hpp"
 #include "../../include/Date.hpp"
+#include "../../include/EventLoop.hpp"
 #include "../../include/HashTable.hpp"
 #include "../../include/List.hpp"
 #include "../../include/LogHistory.hpp"
-#include "../../include/Messaging.hpp"
+#include "../../include/QueryProtocol.hpp"
 #include "../../include/SocketLibrary.hpp"
+#include "../../include/SortedArray.hpp"
+#include "include/BatchedRequest.hpp"
 #include "include/MonitorInfo.hpp"
 #include "include/Request.hpp"
 #include "include/RequestRegistry.hpp"
+#include "include/Verdict.hpp"
 #include "include/VirusRegistry.hpp"
 #include "include/WorkDistribution.hpp"
 
@@ -28,50 +33,260 @@ void alarmHandler(int signo) {
     return;
 }
 
-// Receives and stores all viruses and bloomfilters from a Monitor
-void getMonitorInfo(List<VirusRegistry> &virusList, MonitorInfo *monitorPtr,
-                    unsigned int bloomSize, unsigned int bufferSize) {
-    VirusRegistry virus(bloomSize);
+// Returns the next message of a Monitor. The client can't go on without any of them.
+char *readAnswer(MonitorInfo *monitorPtr) {
+    char *message = monitorPtr->getConnection()->readMessage();
+    if (!message) die("socket/recv", 17);
+    return message;
+}
+
+// Receives and stores the viruses and bloomfilters that changed in a Monitor
+void getMonitorInfo(SortedArray<VirusRegistry> &virusList, MonitorInfo *monitorPtr) {
+    VirusRegistry virus;
     VirusRegistry *virusPtr = NULL;
     string line;
     List<string> args;
     char *buffer;
+    unsigned int bloomBytes = 0, bloomFunctions = 0, bloomDeltas = 0, bloomEncoded = 0, filterType = 0;
+    unsigned int bloomLayer = 0, virusID = 0;
+    bool bloomOk = true;
 
-    // Format: [PID] [STATUS] [INCONSISTENT] [DUPLICATES] [TOTAL READ] [NUM VIRUSES]
+    // Format: [PID] [STATUS] [INCONSISTENT] [DUPLICATES] [TOTAL READ] [NUM FILTERS]
     // This message can be used to track errors in initialization phase
-    buffer = receivePackets(monitorPtr->getSocket(), bufferSize);
-    line.assign(buffer);
-    delete[] buffer;
+    line.assign(readAnswer(monitorPtr));
     splitLine(line, args);
 
     if (args.empty() || myStoi(*args.getNode(1)) == false)
         std::cout << MONITOR_ERROR(monitorPtr->PID());
 
-    unsigned int numViruses = myStoi(args.getLast());
+    // Every bloom filter layer comes on its own, with the name of its virus
+    unsigned int numFilters = myStoi(args.getLast());
     
-    for (unsigned int v = 0; v < numViruses; v++) {
+    for (unsigned int f = 0; f < numFilters; f++) {
         // Read current virus name
-        buffer = receivePackets(monitorPtr->getSocket(), bufferSize);
-        virus.setName(toString(buffer));
-        delete[] buffer;
-
-        // Read the bloom filter array of the current virus
-        buffer = receivePackets(monitorPtr->getSocket(), bufferSize);
-        // And store it in the virus object
-        virus.initializeBloom(buffer, bloomSize);
-
-        virusPtr = virusList.search(virus);
-        if (!virusPtr) {
-            // If virus is not in the list, insert and search again
-            virusList.insertAscending(virus);
-            virusPtr = virusList.search(virus);
-            // Now initialise its filter from the virus object
-            virusPtr->initializeBloom(virus);
-        } else {
-            virusPtr->mergeBloom(buffer, bloomSize);
+        virus.setName(toString(readAnswer(monitorPtr)));
+
+        // Read the size in bytes and hash functions of its bloom filter, the number
+        // of changed words that follow, or 0 for the whole array, the size of
+        // the whole array if it's run-length encoded, or 0 if it's raw, the
+        // type of filter (BLOOM_FILTER, XOR_FILTER or ROARING_FILTER), the
+        // layer of the bloom filter it is and the id of the virus in queries
+        // Format: [BYTES] [FUNCTIONS] [DELTAS] [ENCODED] [TYPE] [LAYER] [VIRUS-ID]
+        line.assign(readAnswer(monitorPtr));
+        splitLine(line, args);
+        bloomBytes = myStoi(*args.getNode(0));
+        bloomFunctions = myStoi(*args.getNode(1));
+        bloomDeltas = myStoi(*args.getNode(2));
+        bloomEncoded = myStoi(*args.getNode(3));
+        filterType = myStoi(*args.getNode(4));
+        bloomLayer = myStoi(*args.getNode(5));
+        virusID = myStoi(*args.getNode(6));
+
+        // Read the bloom filter array of the current virus, or its deltas
+        buffer = readAnswer(monitorPtr);
+        // The virus is inserted only if it's not in the list already,
+        // then this monitor's filter of it is replaced or patched
+        virusPtr = virusList.insert(virus);
+        virusPtr->setVirusID(monitorPtr->PID(), virusID);
+        if (filterType == XOR_FILTER)
+            bloomOk = virusPtr->setXorFilter(monitorPtr->PID(), buffer, bloomBytes);
+        else if (filterType == ROARING_FILTER)
+            bloomOk = virusPtr->setRoaringBitmap(monitorPtr->PID(), buffer, bloomBytes);
+        else if (bloomDeltas)
+            bloomOk = virusPtr->patchBloom(monitorPtr->PID(), bloomLayer, buffer, bloomDeltas, bloomBytes);
+        else if (bloomEncoded)
+            bloomOk = virusPtr->setEncodedBloom(monitorPtr->PID(), bloomLayer, buffer, bloomEncoded,
+                                                bloomBytes, bloomFunctions);
+        else
+            bloomOk = virusPtr->setBloom(monitorPtr->PID(), bloomLayer, buffer, bloomBytes, bloomFunctions);
+        if (!bloomOk) std::cerr << MONITOR_ERROR(monitorPtr->PID());
+    }
+}
+
+// Replaces the socket of a monitor that refused a connection, or that the
+// socket connected to itself instead, since a socket whose connect failed
+// can't be connected again everywhere
+void renewSocket(MonitorInfo *monitorPtr) {
+    // A socket that connected to itself holds the port the monitor
+    // is about to listen to, so it must not linger in TIME_WAIT
+    abortSocket(monitorPtr->getSocket());
+    monitorPtr->setSocket(createSocket());
+    setBlocking(monitorPtr->getSocket(), false);
+}
+
+// Counts and saves a travelRequest with its final status, then informs the
+// monitor of it with a message that needs no answer
+void completeRequest(MonitorInfo *monitorPtr, Request &request, string countryTo,
+                     SortedArray<RequestRegistry> &registryList,
+                     unsigned int &acceptedReqs, unsigned int &rejectedReqs) {
+    RequestRegistry registry(countryTo);
+    travelResult result = {QUERY_TRAVEL_RESULT, request.getStatus()};
+
+    // Update counters
+    request.getStatus() ? acceptedReqs++ : rejectedReqs++;
+
+    // Save the request data
+    registryList.insert(registry)->addRequest(request);
+
+    monitorPtr->getConnection()->writeMessage((const char *)&result, sizeof(result));
+}
+
+// Prints the verdicts of the travelRequests that are answered,
+// up to the first one that still waits for its monitor
+void printVerdicts(List<Verdict> &verdicts) {
+    while (!verdicts.empty() && verdicts.getFirst().getMessage()) {
+        std::cout << verdicts.getFirst().getMessage();
+        verdicts.popFirst();
+    }
+}
+
+// Reads the next answer of a monitor to its pending travelRequests, which
+// may come in any order, and completes the request it answers. Its verdict
+// is printed after those of the requests that were made before it.
+void answerRequest(MonitorInfo *monitorPtr, List<Verdict> &verdicts, SortedArray<RequestRegistry> &registryList,
+                   unsigned int &acceptedReqs, unsigned int &rejectedReqs) {
+    List<PendingRequest> &pending = monitorPtr->getPending();
+    PendingRequest *pendingPtr = NULL;
+    Verdict *verdictPtr = NULL;
+    const char *verdict = COUT_REQ_REJECTED;
+    Connection *connection = monitorPtr->getConnection();
+    travelAnswer answer;
+    char *message = NULL;
+    unsigned int id = 0;
+    Date date2;
+
+    message = readAnswer(monitorPtr);
+    if (messageOpcode(message, connection->getMessageSize()) != ANSWER_TRAVEL_REQUEST ||
+        !decodeMessage(message, connection->getMessageSize(), answer)) { std::cerr << UNKNOWN_ERROR; return; }
+    id = ntohl(answer.requestID);
+    if (!(pendingPtr = pending.search(PendingRequest(id))) ||
+        !(verdictPtr = verdicts.search(Verdict(id)))) { std::cerr << UNKNOWN_ERROR; return; }
+    Request &request = pendingPtr->getRequest();
+
+    // The monitor has the final word on what the filter let through
+    request.getVirus().registerAnswer(answer.vaccinated);
+
+    request.setStatus(false);
+    if (answer.vaccinated) {
+        date2.unpack(ntohl(answer.date));
+        if (request.getDate().daysDifference(date2) >= (6*DAYS_PER_MONTH))
+            verdict = COUT_REQ_REJECTED2;
+        else if (request.getDate().daysDifference(date2) >= 0) {
+            request.setStatus(true);
+            verdict = COUT_REQ_ACCEPTED;
+        }
+    }
+    verdictPtr->setMessage(verdict);
+    printVerdicts(verdicts);
+
+    completeRequest(monitorPtr, request, pendingPtr->getCountryTo(), registryList, acceptedReqs, rejectedReqs);
+    pending.popValue(PendingRequest(id));
+}
+
+// Returns the position of an awaited monitor that has a message ready, reading
+// whatever arrives from any monitor until one of them does. Any messages
+// the awaited monitors have to answer must have been flushed already.
+unsigned int nextMessage(EventLoop &loop, List<MonitorInfo> &monitorList, const bool *awaited) {
+    void *ready[EVENT_LOOP_MAX_EVENTS];
+    unsigned int numReady = 0;
+
+    while (true) {
+        for (unsigned int mon = 0; mon < monitorList.getSize(); mon++)
+            if (awaited[mon] && monitorList.getNode(mon)->getConnection()->messageReady())
+                return mon;
+        numReady = loop.wait(ready, EVENT_LOOP_MAX_EVENTS, -1);
+        for (unsigned int r = 0; r < numReady; r++)
+            ((MonitorInfo *)ready[r])->getConnection()->receive();
+    }
+}
+
+// Collects the answers to all the pending travelRequests of all monitors,
+// in the order they arrive, so that every verdict is printed
+void collectAllAnswers(EventLoop &loop, List<MonitorInfo> &monitorList, List<Verdict> &verdicts,
+                       SortedArray<RequestRegistry> &registryList,
+                       unsigned int &acceptedReqs, unsigned int &rejectedReqs) {
+    bool *awaited = new bool[monitorList.getSize()];
+    unsigned int numAwaited = 0, mon = 0;
+    MonitorInfo *monitorPtr = NULL;
+
+    // So that all monitors answer at the same time
+    for (mon = 0; mon < monitorList.getSize(); mon++) {
+        monitorPtr = monitorList.getNode(mon);
+        awaited[mon] = !monitorPtr->getPending().empty();
+        if (awaited[mon]) {
+            monitorPtr->getConnection()->flush();
+            numAwaited++;
         }
-        delete[] buffer;
     }
+
+    while (numAwaited) {
+        mon = nextMessage(loop, monitorList, awaited);
+        monitorPtr = monitorList.getNode(mon);
+        answerRequest(monitorPtr, verdicts, registryList, acceptedReqs, rejectedReqs);
+        if (monitorPtr->getPending().empty()) {
+            awaited[mon] = false;
+            numAwaited--;
+        }
+    }
+    delete[] awaited;
+}
+
+// Checks the citizens of the batched travelRequests against the filters, those
+// of the same virus and monitor with one batched lookup, then rejects the
+// requests the filters rule out and promotes the rest to their monitors,
+// without waiting for the answers, in the order they were made
+void checkBatch(List<BatchedRequest> &batch, List<Verdict> &verdicts, SortedArray<RequestRegistry> &registryList,
+                unsigned int &acceptedReqs, unsigned int &rejectedReqs) {
+    unsigned int size = batch.getSize(), ids[BLOOM_BATCH], group[BLOOM_BATCH];
+    bool checked[BLOOM_BATCH] = {false}, passed[BLOOM_BATCH], hits[BLOOM_BATCH];
+    BatchedRequest *batchedPtr = NULL;
+    MonitorInfo *monitorPtr = NULL;
+    travelQuery query;
+
+    for (unsigned int first = 0; first < size; first++) {
+        if (checked[first]) continue;
+        batchedPtr = batch.getNode(first);
+        VirusRegistry &virus = batchedPtr->getPending().getRequest().getVirus();
+        unsigned int groupSize = 0;
+        for (unsigned int pos = first; pos < size; pos++) {
+            BatchedRequest *otherPtr = batch.getNode(pos);
+            if (otherPtr->getMonitor() != batchedPtr->getMonitor() ||
+                &otherPtr->getPending().getRequest().getVirus() != &virus) continue;
+            checked[pos] = true;
+            ids[groupSize] = otherPtr->getCitizenID();
+            group[groupSize++] = pos;
+        }
+        virus.checkBloom(batchedPtr->getMonitor()->PID(), ids, groupSize, hits);
+        for (unsigned int g = 0; g < groupSize; g++) passed[group[g]] = hits[g];
+    }
+
+    for (unsigned int pos = 0; pos < size; pos++) {
+        batchedPtr = batch.getNode(pos);
+        monitorPtr = batchedPtr->getMonitor();
+        PendingRequest &pending = batchedPtr->getPending();
+
+        if (!passed[pos]) {
+            verdicts.search(Verdict(pending.getID()))->setMessage(COUT_REQ_REJECTED);
+            completeRequest(monitorPtr, pending.getRequest(), pending.getCountryTo(),
+                            registryList, acceptedReqs, rejectedReqs);
+            continue;
+        }
+
+        // Make room for the request among those that wait for this monitor
+        while (monitorPtr->getPending().getSize() >= PIPELINE_DEPTH)
+            answerRequest(monitorPtr, verdicts, registryList, acceptedReqs, rejectedReqs);
+
+        // Its answer is read along with those of any other pending requests
+        query.opcode = QUERY_TRAVEL_REQUEST;
+        query.reserved = 0;
+        query.virusID = htons(pending.getRequest().getVirus().getVirusID(monitorPtr->PID()));
+        query.requestID = htonl(pending.getID());
+        query.citizenID = htonl(batchedPtr->getCitizenID());
+        monitorPtr->getConnection()->writeMessage((const char *)&query, sizeof(query));
+        monitorPtr->getPending().insertLast(pending);
+    }
+    batch.flush();
+    printVerdicts(verdicts);
 }
 
 int main(int argc, char *argv[]) {
@@ -82,6 +297,8 @@ int main(int argc, char *argv[]) {
     List<string> args;
     for (int i = 0; i < argc; i++) args.insertLast(argv[i]);
     if (!checkTravelArgs(args)) die("travel/input", -1);
+    // Lets std::cin tell whether a command is waiting to be read
+    std::ios::sync_with_stdio(false);
 
     // =========== Variables Start ===========
 
@@ -99,14 +316,20 @@ int main(int argc, char *argv[]) {
     pid_t pid = 0;
     int status = 0, exitStatus = 0;
     string line, country;
-    bool reqAnswer = false, found = false;
-    char *buffer = NULL, hostName[NI_MAXHOST], symbolicIP[100];
+    bool found = false;
+    char hostName[NI_MAXHOST], symbolicIP[100];
     unsigned int acceptedReqs = 0, rejectedReqs = 0;
     unsigned int localAccRecs = 0, localRejRecs = 0;
+    unsigned int requestID = 0, size = 0, numViruses = 0;
+    uint32_t packedDate = 0;
+    const char *message = NULL, *dates = NULL, *pos = NULL, *end = NULL, *str = NULL;
+    unsigned int mon = 0, numConnected = 0, numReady = 0;
+    int socketError = 0;
+    socklen_t socketErrorLen = 0;
 
     /* Objects */
     MonitorInfo monitor;
-    VirusRegistry virus(bloomSize);
+    VirusRegistry virus;
     Request request;
     RequestRegistry registry;
     Date date1, date2;
@@ -118,19 +341,34 @@ int main(int argc, char *argv[]) {
     Request *reqPtr = NULL;
     RequestRegistry *registryPtr = NULL;
 
+    /* Messages */
+    queryHeader header;
+    statusQuery statusReq;
+    statusAnswer statusReply;
+
     /* Structs */
     List<MonitorInfo> monitorList;
     // A map of $numMonitor lists with country names that they are responsible for
     List<string> *monitorWorkMap;
     // A list of known countries based on sub-directories read
     List<string> countryList;
-    // A list of known viruses based on requests
-    List<VirusRegistry> virusList;
+    // Known viruses based on requests, sorted by name
+    SortedArray<VirusRegistry> virusList;
     // This entity stores all requests made to the travelClient
     // distinguished by the destination country
-    List<RequestRegistry> registryList;
+    SortedArray<RequestRegistry> registryList;
+    // Verdicts of the travelRequests in the order they were made
+    List<Verdict> verdicts;
+    // TravelRequests whose citizens haven't been checked against the filters yet
+    List<BatchedRequest> batch;
 
     /* Networking variables */
+    // Waits on all the monitors at once
+    EventLoop loop;
+    void *ready[EVENT_LOOP_MAX_EVENTS];
+    // The monitors that are connected, those that a connection to is in
+    // progress, and those that a message is awaited from, at any moment
+    bool *connected = NULL, *connecting = NULL, *awaited = NULL;
     struct sockaddr *serverPtr = NULL;
     hostent *remHost = NULL;
     struct in_addr **addr_list = NULL;
@@ -229,38 +467,92 @@ int main(int argc, char *argv[]) {
         } else monitorList.getNode(mon)->setPID(pid);
     }
 
+    // Connect to all the monitors at once
+    connected = new bool[numMonitors]();
+    connecting = new bool[numMonitors]();
+    awaited = new bool[numMonitors]();
     for (unsigned int mon = 0; mon < numMonitors; mon++) {
         monitorPtr = monitorList.getNode(mon);
-        serverPtr = (struct sockaddr *)&monitorPtr->getServer();
         std::cout << ATTEMPTING_CONN(remHost->h_name, monitorPtr->getPort());
+        setBlocking(monitorPtr->getSocket(), false);
+    }
 
-        // The alarm protects from connection timing-out
-        alarm(TIME_OUT);
-        do {
-            errno = 0;
-            if (connect(monitorPtr->getSocket(), serverPtr, monitorPtr->getSockLen()) < 0)
-                if (errno != ECONNREFUSED) die("travel/socket/connect", 3);
-            // ECONNREFUSED happens only when there is no-one to listen
-            // to this socket, but since we know we have to correct socket,
-            // this indicates that the server is not up yet. So we can keep
-            // attempting to connect until we succeed.
-        } while (errno && !alarmTimeOut);
-        
-        if (alarmTimeOut) {
-            std::cerr << CONNECTION_TIMED_OUT;
-            // Terminate all monitors
-            for (unsigned int mon = 0; mon < numMonitors; mon++)
-                kill(monitorList.getNode(mon)->PID(), SIGKILL);
-            for (unsigned int mon = 0; mon < numMonitors; mon++)
-                waitpid(monitorList.getNode(mon)->PID(), NULL, 0);
-            exit(EXIT_FAILURE);
+    // The alarm protects from connection timing-out
+    alarm(TIME_OUT);
+    while (numConnected < numMonitors && !alarmTimeOut) {
+        for (unsigned int mon = 0; mon < numMonitors; mon++) {
+            if (connected[mon] || connecting[mon]) continue;
+            monitorPtr = monitorList.getNode(mon);
+            serverPtr = (struct sockaddr *)&monitorPtr->getServer();
+            if (connect(monitorPtr->getSocket(), serverPtr, monitorPtr->getSockLen()) == 0) {
+                if (connectedToItself(monitorPtr->getSocket())) { renewSocket(monitorPtr); continue; }
+                connected[mon] = true;
+                numConnected++;
+            } else if (errno == EINPROGRESS) {
+                // The loop tells when the connection is complete
+                connecting[mon] = true;
+                loop.watch(monitorPtr->getSocket(), EPOLLOUT, monitorPtr);
+            } else if (errno == ECONNREFUSED) {
+                // ECONNREFUSED happens only when there is no-one to listen
+                // to this socket, but since we know we have to correct socket,
+                // this indicates that the server is not up yet. So we can keep
+                // attempting to connect until we succeed.
+                renewSocket(monitorPtr);
+            } else if (errno != EINTR) die("travel/socket/connect", 3);
+        }
+        if (numConnected == numMonitors) break;
+
+        // Wait for the connections in progress, or a while before attempting again
+        numReady = loop.wait(ready, EVENT_LOOP_MAX_EVENTS, CONNECT_RETRY_DELAY);
+        for (unsigned int r = 0; r < numReady; r++) {
+            monitorPtr = (MonitorInfo *)ready[r];
+            loop.unwatch(monitorPtr->getSocket());
+            socketError = 0;
+            socketErrorLen = sizeof(socketError);
+            getsockopt(monitorPtr->getSocket(), SOL_SOCKET, SO_ERROR, &socketError, &socketErrorLen);
+            if (socketError && socketError != ECONNREFUSED) {
+                errno = socketError;
+                die("travel/socket/connect", 3);
+            }
+            for (mon = 0; monitorList.getNode(mon) != monitorPtr; mon++);
+            connecting[mon] = false;
+            if (!socketError && !connectedToItself(monitorPtr->getSocket())) {
+                connected[mon] = true;
+                numConnected++;
+            } else renewSocket(monitorPtr);
         }
-        // Cancel pending alarms after successfull connection
-        alarm(0);
     }
 
-    for (unsigned int mon = 0; mon < numMonitors; mon++)
-        getMonitorInfo(virusList, monitorList.getNode(mon), bloomSize, bufferSize);
+    if (alarmTimeOut) {
+        std::cerr << CONNECTION_TIMED_OUT;
+        // Terminate all monitors
+        for (unsigned int mon = 0; mon < numMonitors; mon++)
+            kill(monitorList.getNode(mon)->PID(), SIGKILL);
+        for (unsigned int mon = 0; mon < numMonitors; mon++)
+            waitpid(monitorList.getNode(mon)->PID(), NULL, 0);
+        exit(EXIT_FAILURE);
+    }
+    // Cancel pending alarms after successfull connection
+    alarm(0);
+
+    for (unsigned int mon = 0; mon < numMonitors; mon++) {
+        monitorPtr = monitorList.getNode(mon);
+        // Messages are still sent and received whole, the loop only tells
+        // which monitors have something to read
+        setBlocking(monitorPtr->getSocket(), true);
+        // Messages are read into a buffer of socketBufferSize bytes at first
+        monitorPtr->setConnection(new Connection(monitorPtr->getSocket(), bufferSize));
+        loop.watch(monitorPtr->getSocket(), EPOLLIN, monitorPtr);
+        // Every monitor sends its bloom filters as soon as it accepts
+        awaited[mon] = true;
+    }
+
+    // Receive the bloom filters of the monitors in the order they arrive
+    for (unsigned int received = 0; received < numMonitors; received++) {
+        mon = nextMessage(loop, monitorList, awaited);
+        getMonitorInfo(virusList, monitorList.getNode(mon));
+        awaited[mon] = false;
+    }
 
     std::cout << SERVER_STARTED;
 
@@ -276,6 +568,11 @@ int main(int argc, char *argv[]) {
 
         option = -1;
         while (option == -1) {
+            // Pending travelRequests are answered once no more commands are waiting
+            if (std::cin.rdbuf()->in_avail() <= 0) {
+                checkBatch(batch, verdicts, registryList, acceptedReqs, rejectedReqs);
+                collectAllAnswers(loop, monitorList, verdicts, registryList, acceptedReqs, rejectedReqs);
+            }
             std::cout << SPOILER;
             getline(std::cin, line);
             if (std::cin.eof() || std::cin.fail()) std::cin.clear();
@@ -288,6 +585,12 @@ int main(int argc, char *argv[]) {
             }
         }
 
+        // Every other command may depend on the answers, or read messages itself
+        if (option != travelRequest) {
+            checkBatch(batch, verdicts, registryList, acceptedReqs, rejectedReqs);
+            collectAllAnswers(loop, monitorList, verdicts, registryList, acceptedReqs, rejectedReqs);
+        }
+
         switch (option) {
 
             case travelRequest:
@@ -310,55 +613,14 @@ int main(int argc, char *argv[]) {
                 // Save the countryTo argument for statistics purpose
                 country.assign(*args.getNode(3));
 
-                // All good with arguments, now execute the query
-                reqAnswer = virusPtr->checkBloom(args.getFirst());
-                if (!reqAnswer) std::cout << COUT_REQ_REJECTED;
-                else {
-                    reqAnswer = false;
-                    // Promote the request to monitorPtr
-                    // Message format: [QUERY-CODE] ["REQUEST"] [ID] [COUNTRY] [VIRUS]
-                    line.assign(toString(travelRequest) + " ");
-                    line.append(toString(REQUEST) + " ");
-                    line.append(args.getFirst() + " ");
-                    line.append(args.getLast());
-
-                    sendPackets(monitorPtr->getSocket(), line.c_str(), line.length()+1, bufferSize);
-                    buffer = receivePackets(monitorPtr->getSocket(), bufferSize);
-                    line.assign(buffer);
-                    delete[] buffer;
-                    splitLine(line, args);
-
-                    if (!args.getFirst().compare("NO")) std::cout << COUT_REQ_REJECTED;
-                    else if (!args.getFirst().compare("YES")) {
-                        date2.set(args.getLast());
-                        if (date1.daysDifference(date2) < 0)
-                            std::cout << COUT_REQ_REJECTED;
-                        else if (date1.daysDifference(date2) >= (6*DAYS_PER_MONTH))
-                            std::cout << COUT_REQ_REJECTED2;
-                        else {
-                            reqAnswer = true;
-                            std::cout << COUT_REQ_ACCEPTED;
-                        }
-                    } else { std::cerr << UNKNOWN_ERROR; break; }
-                }
-
-                // Update counters
-                reqAnswer ? acceptedReqs++ : rejectedReqs++;
-
-                // Save the request data
-                request.set(virusPtr, reqAnswer, date1);
-                registry.setCountry(country);
-                registryPtr = registryList.search(registry);
-                if (!registryPtr) {
-                    registryList.insertAscending(registry);
-                    registryPtr = registryList.search(registry);
-                }
-                registryPtr->addRequest(request);
-
-                // Time to inform the monitor of the request status
-                line.assign(toString(travelRequest) + " ");
-                reqAnswer ? line.append(ACCEPTED) : line.append(REJECTED);
-                sendPackets(monitorPtr->getSocket(), line.c_str(), line.length()+1, bufferSize);
+                // All good with arguments, the citizen is checked against the
+                // filter along with those of the next requests
+                request.set(virusPtr, false, date1);
+                batch.insertLast(BatchedRequest(PendingRequest(++requestID, request, country),
+                                                monitorPtr, myStoi(args.getFirst())));
+                verdicts.insertLast(Verdict(requestID));
+                if (batch.getSize() >= BLOOM_BATCH)
+                    checkBatch(batch, verdicts, registryList, acceptedReqs, rejectedReqs);
                 break;
 
             case travelStats:
@@ -437,17 +699,18 @@ int main(int argc, char *argv[]) {
                 if(!monCountryPtr) { std::cerr << NO_COUNTRY; break; }
 
                 // Notify the responsible monitor
-                line.assign(toString(addRecords));
-                sendPackets(monitorPtr->getSocket(), line.c_str(), line.length()+1, bufferSize);
+                header.opcode = QUERY_ADD_RECORDS;
+                monitorPtr->getConnection()->writeMessage((const char *)&header, sizeof(header));
 
                 // Check if the monitor actually found new records
-                buffer = receivePackets(monitorPtr->getSocket(), bufferSize);
-                line.assign(buffer);
-                delete[] buffer;
-                if (line.compare(UPDATE)) { std::cerr << NO_NEW_FILES; break; }
+                message = readAnswer(monitorPtr);
+                if (messageOpcode(message, monitorPtr->getConnection()->getMessageSize()) != ANSWER_UPDATE) {
+                    std::cerr << NO_NEW_FILES;
+                    break;
+                }
 
                 // Receive the updated bloomfilters from the monitor
-                getMonitorInfo(virusList, monitorPtr, bloomSize, bufferSize);
+                getMonitorInfo(virusList, monitorPtr);
                 std::cout << DATABASE_UPDATED;
                 break;
 
@@ -458,42 +721,69 @@ int main(int argc, char *argv[]) {
 
                 found = false;
                 // Notify all monitors
-                line.assign(toString(searchStatus) + " " + args.getFirst());
-                for (unsigned int mon = 0; mon < monitorList.getSize(); mon++)
-                    sendPackets(monitorList.getNode(mon)->getSocket(), line.c_str(), line.length()+1, bufferSize);
-
-                // They will either reply with ["404"] (not found) or the user data
+                memset(&statusReq, 0, sizeof(statusReq));
+                statusReq.opcode = QUERY_SEARCH_STATUS;
+                statusReq.citizenID = htonl(myStoi(args.getFirst()));
                 for (unsigned int mon = 0; mon < monitorList.getSize(); mon++) {
+                    monitorList.getNode(mon)->getConnection()->writeMessage((const char *)&statusReq, sizeof(statusReq));
+                    // So that all monitors search at the same time
+                    monitorList.getNode(mon)->getConnection()->flush();
+                    awaited[mon] = true;
+                }
+
+                // They will all reply, with the user data if they have them,
+                // which are handled in the order they arrive
+                for (unsigned int replies = 0; replies < monitorList.getSize(); replies++) {
+                    mon = nextMessage(loop, monitorList, awaited);
+                    awaited[mon] = false;
                     monitorPtr = monitorList.getNode(mon);
-                    buffer = receivePackets(monitorPtr->getSocket(), bufferSize);
-                    line.assign(buffer);
-                    delete[] buffer;
+                    message = readAnswer(monitorPtr);
+                    size = monitorPtr->getConnection()->getMessageSize();
+
+                    if (messageOpcode(message, size) != ANSWER_SEARCH_STATUS ||
+                        !decodeMessage(message, size, statusReply) || !statusReply.found) continue;
+                    numViruses = ntohs(statusReply.numViruses);
+                    if (size < sizeof(statusReply) + numViruses * sizeof(uint32_t)) { std::cerr << UNKNOWN_ERROR; continue; }
 
-                    if (!line.compare(NOT_FOUND)) continue;
-                    
                     found = true;
-                    // User data format: [ID] [NAME] [SURNAME] [COUNTRY] [AGE] [VACCINATION-LIST]
-                    splitLine(line, args);
+                    // User data format: [statusAnswer] [DATES] [FIRST NAME] [LAST NAME] [COUNTRY] [VIRUS NAMES]
+                    dates = message + sizeof(statusReply);
+                    pos = dates + numViruses * sizeof(uint32_t);
+                    end = message + size;
                     // Print data
-                    for (unsigned int i = 0; i < 4; i++) {
-                        std::cout << args.getFirst() << " ";
-                        args.popFirst();
-                    }
-                    std::cout << std::endl << "AGE " << args.getFirst() << std::endl;
-                    args.popFirst();
-                    // The remaining data is like: VIRUS1, NO, VIRUS2, 1-1-2021, VIRUS3, NO...
-                    while (!args.empty()) {
-                        std::cout << args.getFirst() << " ";
-                        args.popFirst();
-                        args.getFirst().compare("NO") ?
-                        std::cout << VACCINATED << args.getFirst() : std::cout << NOT_VACCINATED;
+                    std::cout << ntohl(statusReply.citizenID) << " ";
+                    for (unsigned int i = 0; i < 3 && (str = nextString(pos, end)); i++)
+                        std::cout << str << " ";
+                    std::cout << std::endl << "AGE " << ntohl(statusReply.age) << std::endl;
+                    // A date of 0 means that the citizen isn't vaccinated for the virus
+                    for (unsigned int v = 0; v < numViruses && (str = nextString(pos, end)); v++) {
+                        memcpy(&packedDate, dates + v * sizeof(uint32_t), sizeof(packedDate));
+                        std::cout << str << " ";
+                        if (!(packedDate = ntohl(packedDate))) std::cout << NOT_VACCINATED;
+                        else {
+                            date2.unpack(packedDate);
+                            std::cout << VACCINATED << date2;
+                        }
                         std::cout << std::endl;
-                        args.popFirst();
                     }
                 }
                 if (!found) std::cerr << USER_NOT_FOUND;
                 break;
 
+            case bloomStats:
+
+                if (args.getSize() > 1) { std::cerr << ARGS_NUMBER; break; }
+                if (args.getSize() == 1) {
+                    virus.setName(args.getFirst());
+                    if (!(virusPtr = virusList.search(virus))) { std::cerr << NO_VIRUS; break; }
+                    std::cout << std::endl << BLOOM_STATISTICS << std::endl << virusPtr->bloomStats();
+                    break;
+                }
+                std::cout << std::endl << BLOOM_STATISTICS << std::endl;
+                for (unsigned int v = 0; v < virusList.getSize(); v++)
+                    std::cout << virusList.getNode(v)->bloomStats();
+                break;
+
             case help:
                 printOptions();
                 break;
@@ -513,20 +803,27 @@ int main(int argc, char *argv[]) {
         for (unsigned int c = 0; c < monitorWorkMap[mon].getSize(); c++)
             countryList.insertAscending(*monitorWorkMap[mon].getNode(c));
 
-    // Save the request statistics in log files
-    writeLogFile(countryList, toString(LOGS_PATH), PERMS, acceptedReqs, rejectedReqs);
-
-    // Terminate all monitors
-    line.assign(toString(exitProgram));
-    for (unsigned int mon = 0; mon < monitorList.getSize(); mon++)
-        sendPackets(monitorList.getNode(mon)->getSocket(), line.c_str(), line.length()+1, bufferSize);
+    // Save the request and bloom filter statistics in log files
+    line.assign(toString(BLOOM_STATISTICS) + '\n');
+    for (unsigned int v = 0; v < virusList.getSize(); v++)
+        line.append(virusList.getNode(v)->bloomStats());
+    writeLogFile(countryList, toString(LOGS_PATH), PERMS, acceptedReqs, rejectedReqs, line);
+
+    // Terminate all monitors. Other clients they serve keep their sessions.
+    header.opcode = QUERY_SHUTDOWN;
+    for (unsigned int mon = 0; mon < monitorList.getSize(); mon++) {
+        monitorList.getNode(mon)->getConnection()->writeMessage((const char *)&header, sizeof(header));
+        monitorList.getNode(mon)->getConnection()->flush();
+    }
 
     // Wait for all Monitors to finish
     for (unsigned int mon = 0; mon < monitorList.getSize(); mon++)
         waitpid(monitorList.getNode(mon)->PID(), NULL, 0);
 
-    for (unsigned int mon = 0; mon < monitorList.getSize(); mon++)
+    for (unsigned int mon = 0; mon < monitorList.getSize(); mon++) {
+        delete monitorList.getNode(mon)->getConnection();
         closeSocket(monitorList.getNode(mon)->getSocket());
+    }
 
     std::cout << SERVER_STOPPED;
     std::cout << LOG_FILES_SAVED(LOGS_PATH);